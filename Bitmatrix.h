@@ -6,10 +6,14 @@
 
 #include <cstdint>   // for uint32_t and uint64_t
 #include <climits>   // for CHAR_BIT, the number of bits per byte
+#include <cstddef>   // for size_t
+#include <vector>
 
 typedef struct { uint32_t matrix[32]; } bitmatrix32_t;
 typedef struct { uint64_t matrix[64]; } bitmatrix64_t;
 
+template <class T, unsigned int K> class Bitlut;
+
 template <class T>
 class Bitmatrix {
 
@@ -52,7 +56,7 @@ public:
       for ( T i = 0; i < N_BITS; i++, v <<= 1 ) A._matrix[i] = v;
    }
     
-   T matrix( T i ) {   // return the ith vector of the bitmatrix
+   T matrix( T i ) const {   // return the ith vector of the bitmatrix
    
       return _matrix[i];
    }
@@ -63,15 +67,17 @@ public:
    
       T r = T(0);
       T b = T(1);
-      for ( T i = 0; i < N_BITS; i++, v >>= 1 ) if ( v & b ) r ^= A._matrix[i];
+      for ( T i = 0; i < N_BITS; i++, v >>= 1 ) r ^= A._matrix[i] & ( T(0) - ( v & b ) );   // without a branch on each bit
       return r;
    }
    
-   friend Bitmatrix operator*( Bitmatrix<T>& A, const Bitmatrix<T>& B ) {   // multiplication of two Bitmatrices
+   friend Bitmatrix operator*( const Bitmatrix<T>& A, const Bitmatrix<T>& B ) {   // multiplication of two Bitmatrices
    
+      // Method of Four Russians (M4RM): tabulate A once in 4-bit blocks, then each column of B costs N_BITS / 4 lookups
+      Bitlut<T, 4> L( A );
       Bitmatrix<T> C;
    
-      for ( T i = 0; i < N_BITS; i++ ) C._matrix[i] = A * B._matrix[i];
+      for ( T i = 0; i < N_BITS; i++ ) C._matrix[i] = L * B._matrix[i];
       return C;
    }
    
@@ -146,15 +152,101 @@ private:
 
    T _matrix[N_BITS];
 };
+
+// a Bitmatrix in table form (the Method of Four Russians): for each K-bit chunk of a vector, a table of all 2^K XOR
+// combinations of the corresponding columns, so a matrix-vector product takes N_BITS / K lookups instead of N_BITS bit tests;
+// worth building when the same matrix multiplies many vectors
+template <class T, unsigned int K = 8>   // K = 4 or 8 bits per chunk
+class Bitlut {
+
+public:
+
+   static const unsigned int N_BITS   = CHAR_BIT * sizeof( T );   // number of bits
+   static const unsigned int N_CHUNKS = N_BITS / K;              // number of tables
+   static const unsigned int N_ROWS   = 1u << K;                 // entries in each table
+
+   Bitlut( const Bitmatrix<T>& A ) {   // constructor from a Bitmatrix
+   
+      for ( unsigned int j = 0; j < N_CHUNKS; j++ ) {
+      
+         T* t = _table[j];
+         t[0] = T(0);
+         for ( unsigned int b = 0; b < K; b++ ) {   // the entries with highest bit b add column j * K + b to the ones before
+         
+            T a = A.matrix( j * K + b );
+            for ( unsigned int k = 0; k < ( 1u << b ); k++ ) t[ ( 1u << b ) + k ] = t[k] ^ a;
+         }
+      }
+   }
+   
+   friend T operator*( const Bitlut<T, K>& L, T v ) {   // matrix multiplication of a vector
+   
+      T r = T(0);
+      for ( unsigned int j = 0; j < N_CHUNKS; j++, v >>= K ) r ^= L._table[j][ v & ( N_ROWS - 1 ) ];
+      return r;
+   }
+
+private:
+
+   T _table[ N_CHUNKS ][ N_ROWS ];
+};
    // declaration of friends
    //void identity( Bitmatrix<uint32_t>& A );
    uint32_t operator*( const Bitmatrix<uint32_t>& A, uint32_t v );
-   Bitmatrix<uint32_t> operator*( Bitmatrix<uint32_t>& A, const Bitmatrix<uint32_t>& B );
+   Bitmatrix<uint32_t> operator*( const Bitmatrix<uint32_t>& A, const Bitmatrix<uint32_t>& B );
    Bitmatrix<uint32_t> pow( Bitmatrix<uint32_t>& A, uint32_t e, uint32_t c );
 
    //void identity( Bitmatrix<uint64_t>& A );
    uint64_t operator*( const Bitmatrix<uint64_t>& A, uint32_t v );
-   Bitmatrix<uint64_t> operator*( Bitmatrix<uint64_t>& A, const Bitmatrix<uint64_t>& B );
+   Bitmatrix<uint64_t> operator*( const Bitmatrix<uint64_t>& A, const Bitmatrix<uint64_t>& B );
+
+// the powers A^(2^k), k = 0, 1, ..., n - 1, of a Bitmatrix A, computed once and kept,
+// so that a jump by m costs popcount(m) matrix-vector products instead of O(log m) matrix-matrix products
+template <class T>
+class Bitpowers {
+
+public:
+
+   Bitpowers( const Bitmatrix<T>& A, unsigned int n ) : _p( n > 0 ? n : 1 ) {   // constructor from A and the number of powers
+   
+      _p[0] = A;
+      for ( unsigned int k = 1; k < _p.size(); k++ ) _p[k] = _p[k - 1] * _p[k - 1];
+   }
+   
+   T jump( uintmax_t m, T v ) const {   // return A^m * v, for all of m (operator^( T n ) truncates n to the word size T)
+   
+      for ( unsigned int k = 0; m > 0; k++, m >>= 1 ) if ( m & 1 ) v = _pow2( k, v );
+      return v;
+   }
+   
+   T jump( uintmax_t e, uintmax_t c, T v ) const {   // return A^n * v, where n = 2^e + c (as with pow, e = 0 means n = c)
+   
+      v = jump( c, v );
+      if ( e ) v = _pow2( e, v );
+      return v;
+   }
+
+private:
+
+   std::vector< Bitmatrix<T> > _p;   // _p[k] = A^(2^k)
+   
+   T _pow2( uintmax_t e, T v ) const {   // return A^(2^e) * v, squaring past the end of the table if need be
+   
+      if ( e < _p.size() ) return _p[e] * v;
+      Bitmatrix<T> B = _p.back();
+      for ( uintmax_t k = _p.size() - 1; k < e; k++ ) B *= B;
+      return B * v;
+   }
+};
+
+// the Bitpowers of each of the m matrices A[0], ..., A[m-1]
+template <class T, class M>   // M is bitmatrix32_t or bitmatrix64_t
+std::vector< Bitpowers<T> > bitpowers( const M A[], size_t m, unsigned int n ) {
+
+   std::vector< Bitpowers<T> > P;
+   for ( size_t i = 0; i < m; i++ ) P.push_back( Bitpowers<T>( Bitmatrix<T>( A[i] ), n ) );
+   return P;
+}
 
 
 #endif // BITMATRIX_H
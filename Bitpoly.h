@@ -0,0 +1,216 @@
+// Bitpoly.h: jumping a linear generator by polynomial arithmetic mod 2 instead of matrix powers
+// If m(x) is the minimal polynomial of the transition matrix A, then A^n = r(A) with r(x) = x^n mod m(x),
+// so a jump by n takes popcount(n) multiplications of the kept powers x^(2^k) mod m(x) (carry-less, with PCLMULQDQ
+// where available) and one evaluation of r(A) * v by Horner's method, i.e., deg(m) matrix-vector products.
+// Each power takes one 64-bit word, against a whole Bitmatrix for each of the cached powers in Bitpowers.
+
+#ifndef BITPOLY_H
+#define BITPOLY_H
+
+#include "Bitmatrix.h"
+
+#if defined( __PCLMUL__ )
+#include <wmmintrin.h>
+#endif
+
+enum jump_engine_t { MATRIX_JUMP, POLYNOMIAL_JUMP };   // how a generator jumps: cached matrix powers or polynomials
+
+#if !defined( __PCLMUL__ )
+// carry-less product of two polynomials mod 2 of degree < 32, four bits of b at a time
+inline uint64_t clmul32( uint32_t a, uint32_t b ) {
+
+   uint64_t u[16];   // u[k] = a * k
+   u[0] = 0;
+   u[1] = a;
+   for ( unsigned int k = 2; k < 16; k += 2 ) {
+
+      u[k]     = u[ k / 2 ] << 1;
+      u[k + 1] = u[k] ^ a;
+   }
+   uint64_t r = 0;
+   for ( int i = 28; i >= 0; i -= 4 ) r = ( r << 4 ) ^ u[ ( b >> i ) & 15 ];
+   return r;
+}
+#endif
+
+// carry-less product of two polynomials mod 2 of degree < 64, returning the high 64 coefficients in hi and the low in lo
+inline void clmul64( uint64_t a, uint64_t b, uint64_t& hi, uint64_t& lo ) {
+
+#if defined( __PCLMUL__ )
+   __m128i p = _mm_clmulepi64_si128( _mm_cvtsi64_si128( a ), _mm_cvtsi64_si128( b ), 0x00 );
+   lo = uint64_t( _mm_cvtsi128_si64( p ) );
+   hi = uint64_t( _mm_cvtsi128_si64( _mm_unpackhi_epi64( p, p ) ) );
+#else
+   uint32_t a0 = uint32_t( a ), a1 = uint32_t( a >> 32 );   // Karatsuba on the 32-bit halves
+   uint32_t b0 = uint32_t( b ), b1 = uint32_t( b >> 32 );
+   uint64_t l = clmul32( a0, b0 );
+   uint64_t h = clmul32( a1, b1 );
+   uint64_t m = clmul32( a0 ^ a1, b0 ^ b1 ) ^ l ^ h;
+   lo = l ^ ( m << 32 );
+   hi = h ^ ( m >> 32 );
+#endif
+}
+
+template <class T>
+class Bitpoly {
+
+public:
+
+   static const unsigned int N_BITS = CHAR_BIT * sizeof( T );   // number of bits
+
+   Bitpoly( const Bitmatrix<T>& A, unsigned int n ) : _lut( A ), _p( n > 0 ? n : 1 ) {   // constructor from A and the number of powers
+
+      _minimal( A );
+      _s = 64 - _d;
+      _M = _d < 64 ? _m << _s : _m;
+
+      uint64_t hi = _M, lo = 0;   // Barrett constant mu = floor( x^128 / M ) = x^64 + _mu, by long division
+      _mu = 0;
+      for ( int j = 127; j >= 64; j-- ) {
+
+         if ( ( hi >> ( j - 64 ) ) & 1 ) {
+
+            unsigned int k = j - 64;   // subtract x^k * M, whose leading term cancels bit j
+            _mu |= uint64_t(1) << k;
+            hi  ^= uint64_t(1) << k;
+            if ( k ) hi ^= _M >> ( 64 - k );
+            lo ^= _M << k;
+         }
+      }
+
+      _p[0] = _mulx( 1 );
+      for ( unsigned int k = 1; k < _p.size(); k++ ) _p[k] = _mulmod( _p[k - 1], _p[k - 1] );
+   }
+
+   unsigned int degree( void ) const {   // degree d of the minimal polynomial
+
+      return _d;
+   }
+
+   uint64_t polynomial( void ) const {   // coefficients of x^0, ..., x^(d-1) of the (monic) minimal polynomial
+
+      return _m;
+   }
+
+   T jump( uintmax_t n, T v ) const {   // return A^n * v
+
+      return _horner( _xpow( n ), v );
+   }
+
+   T jump( uintmax_t e, uintmax_t c, T v ) const {   // return A^n * v, where n = 2^e + c (as with pow, e = 0 means n = c)
+
+      uint64_t r = _xpow( c );
+      if ( e ) r = _mulmod( r, _pow2( e ) );
+      return _horner( r, v );
+   }
+
+private:
+
+   Bitlut<T, 8> _lut;   // A in table form, for the matrix-vector products of Horner's method
+   unsigned int _d;     // degree of the minimal polynomial m(x) = x^_d + _m
+   unsigned int _s;     // 64 - _d
+   uint64_t     _m;     // low coefficients of m(x)
+   uint64_t     _M;     // low coefficients of M(x) = x^_s * m(x) = x^64 + _M
+   uint64_t     _mu;    // low coefficients of floor( x^128 / M(x) ) = x^64 + _mu
+   std::vector<uint64_t> _p;   // _p[k] = x^(2^k) mod m(x)
+
+   // the minimal polynomial of A, from the first power A^d that is a linear combination of I, A, ..., A^(d-1),
+   // found by Gaussian elimination on the N_BITS^2 bits of each power
+   void _minimal( const Bitmatrix<T>& A ) {
+
+      std::vector< std::vector<T> > row;   // reduced powers, each with its pivot and the combination of powers it holds
+      std::vector<size_t> piv;
+      std::vector<uint64_t> comb;
+
+      Bitmatrix<T> P;
+      P.identity( P );
+      for ( unsigned int d = 0; d <= N_BITS; d++, P *= A ) {
+
+         std::vector<T> w( N_BITS );
+         for ( unsigned int i = 0; i < N_BITS; i++ ) w[i] = P.matrix( i );
+         uint64_t c = 0;
+         for ( size_t j = 0; j < row.size(); j++ ) {
+
+            if ( ( w[ piv[j] / N_BITS ] >> ( piv[j] % N_BITS ) ) & 1 ) {
+
+               for ( unsigned int i = 0; i < N_BITS; i++ ) w[i] ^= row[j][i];
+               c ^= comb[j];
+            }
+         }
+         size_t p = 0;
+         while ( p < N_BITS * N_BITS && !( ( w[ p / N_BITS ] >> ( p % N_BITS ) ) & 1 ) ) p++;
+         if ( p == N_BITS * N_BITS ) {   // A^d + c(A) = 0
+
+            _d = d;
+            _m = c;
+            return;
+         }
+         row.push_back( w );
+         piv.push_back( p );
+         comb.push_back( c | uint64_t(1) << d );   // d < N_BITS here, since the minimal polynomial has degree <= N_BITS
+      }
+   }
+
+   uint64_t _mulx( uint64_t r ) const {   // return x * r(x) mod m(x)
+
+      uint64_t top = ( r >> ( _d - 1 ) ) & 1;
+      r = _d < 64 ? ( r << 1 ) & ( ( uint64_t(1) << _d ) - 1 ) : r << 1;
+      return r ^ ( _m & ( uint64_t(0) - top ) );
+   }
+
+   uint64_t _mulmod( uint64_t a, uint64_t b ) const {   // return a(x) * b(x) mod m(x), by Barrett reduction mod M(x)
+
+      uint64_t hi, lo, qh, ql;
+      clmul64( a, b, hi, lo );
+      if ( _s ) {   // a * b * x^_s mod M = ( a * b mod m ) * x^_s
+
+         hi = ( hi << _s ) | ( lo >> ( 64 - _s ) );
+         lo <<= _s;
+      }
+      clmul64( hi, _mu, qh, ql );
+      uint64_t q = hi ^ qh;   // quotient floor( a * b * x^_s / M )
+      clmul64( q, _M, qh, ql );
+      return ( lo ^ ql ) >> _s;
+   }
+
+   uint64_t _pow2( uintmax_t e ) const {   // return x^(2^e) mod m(x), squaring past the end of the table if need be
+
+      if ( e < _p.size() ) return _p[e];
+      uint64_t r = _p.back();
+      for ( uintmax_t k = _p.size() - 1; k < e; k++ ) r = _mulmod( r, r );
+      return r;
+   }
+
+   uint64_t _xpow( uintmax_t n ) const {   // return x^n mod m(x), the product of x^(2^k) over the bits k of n
+
+      uint64_t r = 1;
+      bool one = true;
+      for ( unsigned int k = 0; n > 0; k++, n >>= 1 ) {
+
+         if ( n & 1 ) {
+
+            r = one ? _pow2( k ) : _mulmod( r, _pow2( k ) );
+            one = false;
+         }
+      }
+      return r;
+   }
+
+   T _horner( uint64_t r, T v ) const {   // return r(A) * v = ( ... ( r_(d-1) A + r_(d-2) ) A + ... ) A v + r_0 v
+
+      T w = T(0);
+      for ( int i = int( _d ) - 1; i >= 0; i-- ) w = ( _lut * w ) ^ ( v & ( T(0) - T( ( r >> i ) & 1 ) ) );
+      return w;
+   }
+};
+
+// the Bitpoly of each of the m matrices A[0], ..., A[m-1]
+template <class T, class M>   // M is bitmatrix32_t or bitmatrix64_t
+std::vector< Bitpoly<T> > bitpolys( const M A[], size_t m, unsigned int n ) {
+
+   std::vector< Bitpoly<T> > P;
+   for ( size_t i = 0; i < m; i++ ) P.push_back( Bitpoly<T>( Bitmatrix<T>( A[i] ), n ) );
+   return P;
+}
+
+#endif // BITPOLY_H
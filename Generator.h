@@ -5,16 +5,42 @@
 #define GENERATOR_H
 
 #include "Bitmatrix.h"
+#include "Bitpoly.h"
 #include "mod_math.h"
 #include <vector>
 #include <bitset>
 #include <iostream>
 
+#include <cstring>   // for memcpy
+
+// conversions of random integers to uniforms that stay in double (or float) arithmetic, so that they compile to a few
+// SSE/AVX instructions, where the long double of rng64_01() goes through the x87 unit
+
+inline double to53_01( uint64_t x ) {   // double in [0,1) from the top 53 bits, through a signed conversion
+
+   return double( int64_t( x >> 11 ) ) * TWO53_INV;
+}
+
+inline double to52_open01( uint64_t x ) {   // double in (0,1): the top 52 bits stuffed into the mantissa of [1,2), less 1 - 2^(-53)
+
+   uint64_t b = ( x >> 12 ) | 0x3ff0000000000000ULL;
+   double d;
+   memcpy( &d, &b, sizeof( d ) );
+   return d - ( 1. - TWO53_INV );   // exact, odd multiples of 2^(-53) from 2^(-53) to 1 - 2^(-53)
+}
+
+inline float to24_01( uint32_t x ) {   // float in [0,1) from the top 24 bits
+
+   return float( int32_t( x >> 8 ) ) * TWO24_INV;
+}
+
 template <class T>   // for 32-bit and 64-bit generators
 class Generator {
 
 public:
 
+   typedef T result_type;   // uint32_t or uint64_t
+
    virtual ~Generator() {};// std::cout << "deleting Generator" << std::endl; }
    virtual void setState( std::vector<T> seed ) = 0;
    virtual void getState( std::vector<T>& seed ) = 0;
@@ -29,6 +55,104 @@ public:
    virtual double      rng32_01( void ) = 0;   // returns double in [0,1)
    virtual long double rng64_01( void ) = 0;   // returns long double in [0,1)
 
+   // bulk versions fill the array x with n numbers, at the cost of one virtual call per block;
+   // the generators override these with loops that call their own rng32() and rng64() non-virtually
+
+   virtual void fill32( uint32_t x[], size_t n ) {   // fills x with 32-bit integers
+   
+      for ( size_t i = 0; i < n; i++ ) x[i] = this->rng32();
+   }
+   
+   virtual void fill64( uint64_t x[], size_t n ) {   // fills x with 64-bit integers
+   
+      for ( size_t i = 0; i < n; i++ ) x[i] = this->rng64();
+   }
+   
+   virtual void fill32_01( double x[], size_t n ) {   // fills x with doubles in [0,1), 32 bits of resolution
+   
+      for ( size_t i = 0; i < n; i++ ) x[i] = this->rng32_01();
+   }
+   
+   virtual void fill64_01( double x[], size_t n ) {   // fills x with doubles in [0,1), 53 bits of resolution
+   
+      for ( size_t i = 0; i < n; i++ ) x[i] = double( this->rng64() >> 11 ) * TWO53_INV;
+   }
+
+   // the conversions above on the numbers of this generator; the bulk forms fill a block of integers with one call
+   // (fill64_01 is the bulk form of rng53_01)
+
+   double rng53_01( void ) { return to53_01( this->rng64() ); }         // double in [0,1), 53 bits of resolution
+   double rng52_open01( void ) { return to52_open01( this->rng64() ); } // double in (0,1), 52 bits of resolution
+   float  rng24_01( void ) { return to24_01( this->rng32() ); }         // float in [0,1), 24 bits of resolution
+
+   void fill52_open01( double x[], size_t n ) {   // fills x with n doubles in (0,1)
+
+      uint64_t b[ 256 ];
+      for ( size_t i = 0; i < n; i += 256 ) {
+         size_t m = n - i < 256 ? n - i : 256;
+         this->fill64( b, m );
+         for ( size_t j = 0; j < m; j++ ) x[i + j] = to52_open01( b[j] );
+      }
+   }
+
+   void fill24_01( float x[], size_t n ) {   // fills x with n floats in [0,1)
+
+      uint32_t b[ 256 ];
+      for ( size_t i = 0; i < n; i += 256 ) {
+         size_t m = n - i < 256 ? n - i : 256;
+         this->fill32( b, m );
+         for ( size_t j = 0; j < m; j++ ) x[i + j] = to24_01( b[j] );
+      }
+   }
+
+   // unbiased integers in [0,range), range > 0, by Lemire's nearly-divisionless method: the high half of draw * range,
+   // rejecting the draw only when the low half falls below 2^k mod range, which costs a division only when the low
+   // half is below range, so hardly ever for small ranges
+   // Ref: Lemire, D., "Fast Random Integer Generation in an Interval," ACM Trans. Model. Comput. Simul.,
+   //      Vol. 29, No. 1, pp. 3:1-3:12, 2019.
+
+   uint32_t bounded32( uint32_t range ) {   // from 32-bit numbers
+
+      uint64_t m = uint64_t( this->rng32() ) * range;
+      if ( uint32_t( m ) < range ) {
+         uint32_t t = -range % range;   // 2^32 mod range
+         while ( uint32_t( m ) < t ) m = uint64_t( this->rng32() ) * range;
+      }
+      return uint32_t( m >> 32 );
+   }
+
+   uint64_t bounded64( uint64_t range ) {   // from 64-bit numbers
+
+      uint64_t lo, hi = mul128( this->rng64(), range, lo );
+      if ( lo < range ) {
+         uint64_t t = -range % range;   // 2^64 mod range
+         while ( lo < t ) hi = mul128( this->rng64(), range, lo );
+      }
+      return hi;
+   }
+
+   void fill32_bounded( uint32_t x[], size_t n, uint32_t range ) {   // fills x with n integers in [0,range)
+
+      uint32_t t = -range % range;   // one division for the whole array
+      this->fill32( x, n );
+      for ( size_t i = 0; i < n; i++ ) {
+         uint64_t m = uint64_t( x[i] ) * range;
+         while ( uint32_t( m ) < t ) m = uint64_t( this->rng32() ) * range;
+         x[i] = uint32_t( m >> 32 );
+      }
+   }
+
+   void fill64_bounded( uint64_t x[], size_t n, uint64_t range ) {   // fills x with n integers in [0,range)
+
+      uint64_t t = -range % range;
+      this->fill64( x, n );
+      for ( size_t i = 0; i < n; i++ ) {
+         uint64_t lo, hi = mul128( x[i], range, lo );
+         while ( lo < t ) hi = mul128( this->rng64(), range, lo );
+         x[i] = hi;
+      }
+   }
+
    inline double u32( double a = 0., double b = 1. ) { return a + ( b - a ) * this->rng32_01(); }
    inline double u64( double a = 0., double b = 1. ) { return a + ( b - a ) * this->rng64_01(); }
 };
@@ -44,4 +168,10 @@ public:
 #include "jlkiss64.h"
 #include "lfsr258.h"
 
+// multi-lane (SIMD) generators
+#include "Multilane.h"
+#include "lfsr88_simd.h"
+#include "lfsr113_simd.h"
+#include "lfsr258_simd.h"
+
 #endif
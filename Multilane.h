@@ -0,0 +1,243 @@
+// Multilane.h: template base class for generators that run several independent streams side by side
+// Each lane is a copy of the scalar generator G, started 2^e numbers after the previous lane by G's own jump_ahead.
+// A derived class only has to supply _generate(), which advances all the lanes together, typically in SIMD registers.
+// The numbers come out interleaved (lane 0, lane 1, ..., lane LANES-1, lane 0, ...), or in per-lane blocks from fill_lanes().
+
+#ifndef MULTILANE_H
+#define MULTILANE_H
+
+template <class G, unsigned int N_SEEDS, unsigned int LANES>   // scalar generator G with N_SEEDS words of state
+class Multilane : public Generator<typename G::result_type> {
+
+   typedef typename G::result_type T;
+
+public:
+
+   static const unsigned int N_STEPS = 16;                // steps of all the lanes held in the buffer
+   static const unsigned int N_BUF   = N_STEPS * LANES;   // size of the buffer
+
+   Multilane( unsigned int e ) : _e( e ), _next( N_BUF ), _half( false ) { // default constructor, lanes spaced 2^e apart
+   }
+
+   Multilane( std::vector<T> seed, unsigned int e ) : _e( e ), _next( N_BUF ), _half( false ) { // constructor from seed vector
+
+      Multilane::setState( seed );
+   }
+
+   virtual ~Multilane() { // default destructor
+   }
+
+   // a seed of N_SEEDS words seeds lane 0 and the other lanes are spaced 2^e apart from it,
+   // while a seed of N_SEEDS * LANES words sets each lane directly (lane k is seed[ k * N_SEEDS ], ...)
+   virtual void setState( std::vector<T> seed ) { // set the seeds
+
+      assert( seed.size() >= N_SEEDS );
+
+      std::vector<T> s( N_SEEDS );
+      bool lanes = seed.size() >= N_SEEDS * LANES;
+      if ( !lanes ) _g.setState( seed );
+      for ( unsigned int k = 0; k < LANES; k++ ) {
+
+         if ( lanes ) _g.setState( std::vector<T>( seed.begin() + k * N_SEEDS, seed.begin() + ( k + 1 ) * N_SEEDS ) );
+         _g.getState( s );
+         for ( unsigned int j = 0; j < N_SEEDS; j++ ) _s[j][k] = s[j];
+         if ( !lanes && k + 1 < LANES ) _g.jump_ahead( _e, 0 );
+      }
+      _next = N_BUF;
+      _half = false;
+   }
+
+   virtual void getState( std::vector<T>& seed ) { // get the seeds of all the lanes, N_SEEDS * LANES words
+
+      assert( seed.size() >= N_SEEDS * LANES );
+      for ( unsigned int k = 0; k < LANES; k++ )
+         for ( unsigned int j = 0; j < N_SEEDS; j++ ) seed[ k * N_SEEDS + j ] = _s[j][k];
+   }
+
+   void jump_engine( jump_engine_t j ) {   // how the lanes jump, as for G: cached matrix powers (the default) or polynomials
+
+      _g.jump_engine( j );
+   }
+
+   // jumps move every lane along its own stream and discard any buffered numbers
+
+   virtual void jump_ahead( uintmax_t n ) { // jump each lane ahead n numbers
+
+      for ( unsigned int k = 0; k < LANES; k++ ) { _get( k ); _g.jump_ahead( n ); _set( k ); }
+   }
+
+   virtual void jump_ahead( uintmax_t e, uintmax_t c ) {   // jump each lane ahead n numbers, where n = 2^e + c
+
+      for ( unsigned int k = 0; k < LANES; k++ ) { _get( k ); _g.jump_ahead( e, c ); _set( k ); }
+   }
+
+   virtual void jump_back( uintmax_t n ) { // jump each lane back n numbers
+
+      for ( unsigned int k = 0; k < LANES; k++ ) { _get( k ); _g.jump_back( n ); _set( k ); }
+   }
+
+   virtual void jump_back( uintmax_t e, uintmax_t c ) {   // jump each lane back n numbers, where n = 2^e + c
+
+      for ( unsigned int k = 0; k < LANES; k++ ) { _get( k ); _g.jump_back( e, c ); _set( k ); }
+   }
+
+   virtual void jump_cycle( void ) { // jump each lane ahead an entire cycle
+
+      for ( unsigned int k = 0; k < LANES; k++ ) { _get( k ); _g.jump_cycle(); _set( k ); }
+   }
+
+   T next( void ) {   // returns the next number of the interleaved stream
+
+      if ( _next == N_BUF ) {
+         _generate( _buf, N_STEPS );
+         _next = 0;
+      }
+      return _buf[ _next++ ];
+   }
+
+   virtual uint32_t rng32( void ) {   // returns 32-bit integer
+
+      return _rng32( T() );
+   }
+
+   virtual uint64_t rng64( void ) {   // returns 64-bit integer
+
+      return _rng64( T() );
+   }
+
+   virtual double rng32_01( void ) {   // returns a double in [0,1)
+
+      return double( Multilane::rng32() ) * double( TWO32_INV );
+   }
+
+   virtual long double rng64_01( void ) {   // returns a long double in [0,1)
+
+      return ( long double )( Multilane::rng64() ) * TWO64_INV;
+   }
+
+   virtual void fill32( uint32_t x[], size_t n ) {   // fills x with n 32-bit integers
+
+      _fill32( x, n, T() );
+   }
+
+   virtual void fill64( uint64_t x[], size_t n ) {   // fills x with n 64-bit integers
+
+      _fill64( x, n, T() );
+   }
+
+   virtual void fill32_01( double x[], size_t n ) {   // fills x with n doubles in [0,1)
+
+      for ( size_t i = 0; i < n; i++ ) x[i] = double( Multilane::rng32() ) * double( TWO32_INV );
+   }
+
+   virtual void fill64_01( double x[], size_t n ) {   // fills x with n doubles in [0,1), 53 bits of resolution
+
+      for ( size_t i = 0; i < n; i++ ) x[i] = double( Multilane::rng64() >> 11 ) * TWO53_INV;
+   }
+
+   // fills x with n numbers from each lane in turn, so that x[ k * n + i ] is the ith number from lane k;
+   // the lanes continue from their current state and any numbers buffered for next() are discarded
+   void fill_lanes( T x[], size_t n ) {
+
+      for ( size_t i = 0; i < n; i += N_STEPS ) {
+
+         size_t m = n - i < N_STEPS ? n - i : N_STEPS;
+         _generate( _buf, m );
+         for ( size_t j = 0; j < m; j++ )
+            for ( unsigned int k = 0; k < LANES; k++ ) x[ k * n + i + j ] = _buf[ j * LANES + k ];
+      }
+      _next = N_BUF;
+      _half = false;
+   }
+
+protected:
+
+   T _s[ N_SEEDS ][ LANES ];   // component j of lane k is _s[j][k], so each component is one SIMD register
+
+   virtual void _generate( T x[], size_t m ) = 0;   // m steps of all the lanes, interleaved into x[ m * LANES ]
+
+private:
+
+   unsigned int _e;      // lanes are spaced 2^_e apart
+   T _buf[ N_BUF ];      // buffered numbers for next()
+   unsigned int _next;   // index of the next buffered number
+   G _g;                 // scalar generator that a lane is loaded into to be seeded or jumped, with the lanes' jump engine
+
+   void _get( unsigned int k ) {   // load lane k into _g
+
+      std::vector<T> s( N_SEEDS );
+      for ( unsigned int j = 0; j < N_SEEDS; j++ ) s[j] = _s[j][k];
+      _g.setState( s );
+   }
+
+   void _set( unsigned int k ) {   // store _g into lane k
+
+      std::vector<T> s( N_SEEDS );
+      _g.getState( s );
+      for ( unsigned int j = 0; j < N_SEEDS; j++ ) _s[j][k] = s[j];
+      _next = N_BUF;
+      _half = false;
+   }
+
+   // the word size of G decides how 32-bit and 64-bit numbers are put together, the same way G does it
+
+   uint32_t _rng32( uint32_t ) {
+
+      return next();
+   }
+
+   uint32_t _rng32( uint64_t ) {   // low half, then high half, of a 64-bit number
+
+      if ( _half ) { _half = false; return uint32_t( _high ); }
+      uint64_t v = next();
+      _high = uint32_t( v >> 32 );
+      _half = true;
+      return uint32_t( v );
+   }
+
+   uint64_t _rng64( uint32_t ) {
+
+      uint64_t low  = next();
+      uint64_t high = next();
+      return low | ( high << 32 );
+   }
+
+   uint64_t _rng64( uint64_t ) {
+
+      return next();
+   }
+
+   void _fill( T x[], size_t n ) {   // fills x with n numbers of the interleaved stream
+
+      size_t i = 0;
+      while ( i < n && _next < N_BUF ) x[i++] = _buf[ _next++ ];
+      size_t m = ( n - i ) / LANES;
+      _generate( x + i, m );   // straight into x, without the buffer
+      for ( i += m * LANES; i < n; i++ ) x[i] = next();
+   }
+
+   void _fill32( uint32_t x[], size_t n, uint32_t ) {
+
+      _fill( x, n );
+   }
+
+   void _fill32( uint32_t x[], size_t n, uint64_t ) {
+
+      for ( size_t i = 0; i < n; i++ ) x[i] = _rng32( uint64_t() );
+   }
+
+   void _fill64( uint64_t x[], size_t n, uint32_t ) {
+
+      for ( size_t i = 0; i < n; i++ ) x[i] = _rng64( uint32_t() );
+   }
+
+   void _fill64( uint64_t x[], size_t n, uint64_t ) {
+
+      _fill( x, n );
+   }
+
+   bool     _half;   // whether _high holds the second half of a 64-bit number
+   uint32_t _high;
+};
+
+#endif // MULTILANE_H
@@ -7,6 +7,7 @@
 #define RANDOM_H
 
 #include "Generator.h"
+#include "Vecmath.h"
 #include <iostream>
 #include <fstream>
 #include <vector>
@@ -65,32 +66,374 @@ struct point3d {  // spherical coordinates on unit sphere
    double z( void ) { return cos( theta ); }                // z-coordinate
 };
 
-template <class Typename>   // for 32-bit and 64-bit generators
+// access to the generator that drives the distributions: Random<uint32_t> and Random<uint64_t> go through a
+// Generator pointer so that the generator can be selected at runtime, while Random<G> for a concrete generator
+// class G, such as Random<LFSR113::lfsr113>, holds G by value and calls it non-virtually so the step inlines
+
+template <class G>   // concrete generator class, held by value
+struct engine {
+
+   typedef G                       type;
+   typedef G&                      reference;
+   typedef typename G::result_type result_type;
+
+   static reference get( type& g )      { return g; }
+   static uint32_t  rng32( type& g )    { return g.G::rng32(); }
+   static uint64_t  rng64( type& g )    { return g.G::rng64(); }
+   
+   static void fill32( type& g, uint32_t x[], size_t n )   { g.G::fill32( x, n ); }
+   static void fill64( type& g, uint64_t x[], size_t n )   { g.G::fill64( x, n ); }
+   static void fill32_01( type& g, double x[], size_t n )  { g.G::fill32_01( x, n ); }
+   static void fill64_01( type& g, double x[], size_t n )  { g.G::fill64_01( x, n ); }
+};
+
+template <class T>   // abstract Generator, reached through a pointer
+struct virtual_engine {
+
+   typedef Generator<T>*  type;
+   typedef Generator<T>&  reference;
+   typedef T              result_type;
+
+   static reference get( type& g )      { return *g; }
+   static uint32_t  rng32( type& g )    { return g->rng32(); }
+   static uint64_t  rng64( type& g )    { return g->rng64(); }
+   
+   static void fill32( type& g, uint32_t x[], size_t n )   { g->fill32( x, n ); }
+   static void fill64( type& g, uint64_t x[], size_t n )   { g->fill64( x, n ); }
+   static void fill32_01( type& g, double x[], size_t n )  { g->fill32_01( x, n ); }
+   static void fill64_01( type& g, double x[], size_t n )  { g->fill64_01( x, n ); }
+};
+
+template <> struct engine<uint32_t> : public virtual_engine<uint32_t> {};
+template <> struct engine<uint64_t> : public virtual_engine<uint64_t> {};
+
+// the constants of the Marsaglia-Tsang gamma method for shape c, worth keeping when many variates share a shape;
+// below c = 1 the method samples shape c + 1 and boosts the result by u^(1/c)
+struct gamma_param {
+
+   explicit gamma_param( double shape = 1. ) : c( shape ) {
+   
+      assert( c > 0. );
+      d = ( c < 1. ? c + 1. : c ) - 1. / 3.;
+      k = 1. / sqrt( 9. * d );
+      inv_c = 1. / c;
+   }
+   
+   double c;       // shape
+   double d, k;    // d = c - 1/3 (or c + 2/3 below 1), k = 1 / sqrt( 9 d )
+   double inv_c;   // 1 / c, for the boost
+};
+
+// the constants for binomial variates with n trials and success probability p, worth keeping when many variates
+// share them: Hormann's BTRS transformed rejection when n min( p, 1 - p ) >= 10, otherwise inversion by sequential search
+struct binomial_param {
+
+   binomial_param( int trials, double prob ) : n( trials ), p( prob ) {
+   
+      assert( n >= 1 && 0. <= p && p <= 1. );
+      flip = p > 0.5;
+      pp = flip ? 1. - p : p;
+      q = 1. - pp;
+      btrs = n * pp >= 10.;
+      if ( btrs ) {
+      
+         double spq = sqrt( n * pp * q );
+         b     = 1.15 + 2.53 * spq;
+         a     = -0.0873 + 0.0248 * b + 0.01 * pp;
+         c     = n * pp + 0.5;
+         alpha = ( 2.83 + 5.1 / b ) * spq;
+         vr    = 0.92 - 4.2 / b;
+         m     = floor( ( n + 1 ) * pp );
+         lpq   = log( pp / q );
+         h     = lgamma( m + 1. ) + lgamma( n - m + 1. );
+      }
+      else {
+      
+         s  = pp / q;
+         r0 = pow( q, n );
+      }
+   }
+   
+   int    n;              // trials
+   double p;              // probability of success
+   bool   flip;           // whether p > 1/2, so that variates are n minus those for 1 - p
+   double pp, q;          // min( p, 1 - p ) and 1 - pp
+   bool   btrs;           // BTRS, or else inversion
+   double a, b, c, alpha, vr, m, lpq, h;   // BTRS
+   double s, r0;          // inversion: pp / q and q^n, the probability of 0
+};
+
+// the constants for Poisson variates with mean mu, worth keeping when many variates share them: Hormann's PTRS
+// transformed rejection when mu >= 10, otherwise inversion by sequential search
+struct poisson_param {
+
+   explicit poisson_param( double mean ) : mu( mean ) {
+   
+      assert( mu > 0. );
+      ptrs = mu >= 10.;
+      if ( ptrs ) {
+      
+         double smu = sqrt( mu );
+         b        = 0.931 + 2.53 * smu;
+         a        = -0.059 + 0.02483 * b;
+         lalpha   = log( 1.1239 + 1.1328 / ( b - 3.4 ) );
+         vr       = 0.9277 - 3.6224 / ( b - 2. );
+         lmu      = log( mu );
+      }
+      else p0 = exp( -mu );
+   }
+   
+   double mu;                     // mean
+   bool   ptrs;                   // PTRS, or else inversion
+   double a, b, lalpha, vr, lmu;  // PTRS: lalpha = log( 1 / alpha ) and lmu = log( mu )
+   double p0;                     // inversion: exp( -mu ), the probability of 0
+};
+
+// the constants for hypergeometric variates, the successes in n draws without replacement from N items of which K are
+// successes, worth keeping when many variates share them; by symmetry the work is done with n' = min( n, N - n ) draws
+// and K' = min( K, N - K ) successes, by Stadlober's ratio of uniforms (HRUA) when the mean n' K' / N is at least 10,
+// otherwise by inversion by sequential search
+struct hypergeometric_param {
+
+   hypergeometric_param( int trials, int size, int successes ) : n( trials ), N( size ), K( successes ) {
+   
+      assert( 0 <= n && n <= N && N >= 1 && 0 <= K && K <= N );
+      ns = std::min( n, N - n );
+      ks = std::min( K, N - K );
+      double p = double( ks ) / N, q = 1. - p;
+      double mu = ns * p;
+      hrua = mu >= 10.;
+      if ( hrua ) {
+      
+         const double D1 = 1.7155277699214135, D2 = 0.8989161620588988;   // 2 sqrt( 2 / e ) and 3 - 2 sqrt( 3 / e )
+         a = mu + 0.5;
+         double c = sqrt( double( N - ns ) * ns * p * q / ( N - 1 ) + 0.5 );
+         h = D1 * c + D2;
+         double m = floor( ( ns + 1. ) * ( ks + 1. ) / ( N + 2. ) );   // mode
+         g = logFactorial( m ) + logFactorial( ks - m ) + logFactorial( ns - m ) + logFactorial( N - ks - ns + m );
+         b = std::min( std::min( ns, ks ) + 1., floor( a + 16. * c ) );
+      }
+      else p0 = exp( logFactorial( N - ks ) + logFactorial( N - ns ) - logFactorial( N - ks - ns ) - logFactorial( N ) );   // C( N - K', n' ) / C( N, n' )
+   }
+   
+   static double logFactorial( double k ) { return lgamma( k + 1. ); }   // log k!
+   
+   int    n, N, K;       // trials, size, successes
+   int    ns, ks;        // min( n, N - n ) and min( K, N - K )
+   bool   hrua;          // HRUA, or else inversion
+   double a, h, g, b;    // HRUA: a = mean + 1/2, h the hat width, g = log of the pmf at the mode less a constant, b the bound
+   double p0;            // inversion: the probability of 0
+};
+
+// Walker's alias table for a discrete distribution on 0, 1, ..., k - 1 with the given weights, which need not sum to 1,
+// built in O(k) by Vose's method; a variate then costs one 64-bit number, split into a column and a coin
+// Ref: Vose, M. D., "A Linear Algorithm for Generating Random Numbers with a Given Distribution,"
+//      IEEE Transactions on Software Engineering, Vol. 17, No. 9, pp. 972-975, 1991.
+struct alias_table {
+
+   alias_table( void ) {}
+   
+   explicit alias_table( const std::vector< double >& w ) {
+   
+      build( &w[ 0 ], w.size() );
+   }
+   
+   alias_table( const double w[], int k ) {
+   
+      build( w, k );
+   }
+   
+   void build( const double w[], int k ) {
+   
+      assert( k >= 1 );
+      double sum = 0.;
+      for ( int i = 0; i < k; i++ ) {
+         assert( w[ i ] >= 0. );
+         sum += w[ i ];
+      }
+      assert( sum > 0. );
+      
+      std::vector< double > p( k );   // probabilities scaled by k, so that a full column is 1
+      std::vector< int > small, large;
+      for ( int i = 0; i < k; i++ ) {
+         p[ i ] = w[ i ] * k / sum;
+         if ( p[ i ] < 1. ) small.push_back( i );
+         else               large.push_back( i );
+      }
+      
+      threshold.assign( k, uint64_t( 1 ) << 32 );
+      alias.resize( k );
+      for ( int i = 0; i < k; i++ ) alias[ i ] = i;
+      
+      while ( !small.empty() && !large.empty() ) {   // top up each short column with the excess of a tall one
+      
+         int s = small.back(), l = large.back();
+         small.pop_back();
+         threshold[ s ] = uint64_t( ldexp( p[ s ], 32 ) );
+         alias[ s ] = l;
+         p[ l ] -= 1. - p[ s ];
+         if ( p[ l ] < 1. ) {
+            large.pop_back();
+            small.push_back( l );
+         }
+      }   // whatever is left is full, up to rounding
+   }
+   
+   int size( void ) const { return alias.size(); }
+   
+   std::vector< uint64_t > threshold;   // column i keeps i when the 32-bit coin is below threshold[i], 2^32 for a full column
+   std::vector< int >      alias;       // and gives alias[i] otherwise
+};
+
+// a piecewise-linear empirical cdf, with breakpoints x[i] at cumulative probabilities cdf[i] from 0 up to 1, compiled for
+// inversion: a guide table of Chen and Asau, one entry per interval, narrows each lookup to the few intervals that share
+// its bucket, which a branchless binary search then finishes, so a variate costs O(1) expected time however many breakpoints
+// Ref: Chen, H.-C. and Y. Asau, "On Generating Random Variates from an Empirical Distribution,"
+//      AIIE Transactions, Vol. 6, No. 2, pp. 163-166, 1974.
+struct empirical_table {
+
+   empirical_table( void ) {}
+   
+   empirical_table( const std::vector< double >& x, const std::vector< double >& cdf ) {
+   
+      build( x, cdf );
+   }
+   
+   void build( const std::vector< double >& x, const std::vector< double >& cdf ) {
+   
+      // check that this is indeed a cumulative distribution
+      
+      int n = cdf.size();
+      assert( n >= 2 && int( x.size() ) == n );
+      assert( 0. == cdf[ 0 ] && cdf[ n - 1 ] == 1. );
+      for ( int i = 1; i < n; i++ ) assert( cdf[ i - 1 ] < cdf[ i ] );
+      
+      _x = x;
+      _cdf = cdf;
+      _slope.resize( n - 1 );
+      for ( int i = 0; i < n - 1; i++ ) _slope[ i ] = ( x[ i + 1 ] - x[ i ] ) / ( cdf[ i + 1 ] - cdf[ i ] );
+      
+      _m = n - 1;   // buckets [j/m,(j+1)/m), and guide[j] is the last interval that starts at or below j/m
+      _guide.resize( _m + 1 );
+      for ( int j = 0, i = 0; j <= _m; j++ ) {
+         while ( i + 1 < n - 1 && _cdf[ i + 1 ] <= double( j ) / _m ) i++;
+         _guide[ j ] = i;
+      }
+   }
+   
+   double quantile( double u ) const {   // the inverse cdf at u in [0,1)
+   
+      int j  = std::min( int( u * _m ), _m - 1 );   // u * m can round up to m just below 1
+      int lo = _guide[ j ];
+      int len = _guide[ j + 1 ] - lo + 1;   // the interval is one of lo, ..., lo + len - 1
+      
+      const double* base = &_cdf[ lo ];     // branchless binary search for the last cdf[i] <= u
+      while ( len > 1 ) {
+         int half = len / 2;
+         base = base[ half ] <= u ? base + half : base;
+         len -= half;
+      }
+      int i = base - &_cdf[ 0 ];
+      return _x[ i ] + _slope[ i ] * ( u - _cdf[ i ] );
+   }
+   
+   void quantile( double u[], size_t n ) const {   // replaces the n uniforms in u by their quantiles, in any order
+   
+      for ( size_t k = 0; k < n; k++ ) u[ k ] = quantile( u[ k ] );
+   }
+   
+   int size( void ) const { return _x.size(); }   // number of breakpoints
+   
+private:
+
+   std::vector< double > _x, _cdf;
+   std::vector< double > _slope;   // dx/dcdf over each interval
+   std::vector< int >    _guide;
+   int                   _m;       // number of buckets in the guide table
+};
+
+enum normal_method_t { ZIGGURAT_NORMAL, POLAR_NORMAL };                    // how Random::normal() makes its variates
+enum exponential_method_t { INVERSION_EXPONENTIAL, ZIGGURAT_EXPONENTIAL };   // how Random makes its exponential variates
+
+template <class Typename,       // uint32_t or uint64_t for a runtime-selected generator, or a concrete generator class
+          class Real = double>   // float, double or long double: the type of the continuous variates
 class Random {
 
 public:
 
-   Random( Generator<Typename> *gen ) { _gen = gen; }
+   typedef Real real_type;
+
+   Random( typename engine<Typename>::type gen ) :   // a Generator pointer or a generator to copy
+      _gen( gen ), _coins( 0 ), _nCoins( 0 ), _normal( ZIGGURAT_NORMAL ), _polar( false ),
+      _exponential( INVERSION_EXPONENTIAL ) {}
   ~Random( void ) {}  // default destructor
 
+   void normalMethod( normal_method_t m ) { // Ziggurat (the default) or Marsaglia's polar method for normal()
+   
+      _normal = m;
+      _polar  = false;
+   }
+   
+   // inversion, -log(u), (the default) or the Ziggurat method for exponential() and for the distributions built on it:
+   // extremeValue, laplace, rayleigh, weibull and geometric
+   void exponentialMethod( exponential_method_t m ) {
+   
+      _exponential = m;
+   }
+
+   typename engine<Typename>::reference generator( void ) { // the underlying generator, e.g., to jump ahead
+                                                            // (drops the bits held for fair coins, which predate it)
+      _coins  = 0;   // all of it, since _countCoins takes every bit left in _coins
+      _nCoins = 0;
+      return engine<Typename>::get( _gen );
+   }
+
 // Continuous Distributions
 
-   double arcsine( double xMin = 0., double xMax = 1. ) { // Arc Sine
+   Real arcsine( Real xMin = 0., Real xMax = 1. ) { // Arc Sine
 
-      double q = sin( M_PI_2 * _u() );
+      Real q = sin( M_PI_2 * _ur() );
       return xMin + ( xMax - xMin ) * q * q;
    }
    
-   double beta( double v, double w,                    // Beta
-                double xMin = 0., double xMax = 1. ) { // (v > 0. and w > 0.)
+   void arcsine( Real x[], size_t n, Real xMin, Real xMax ) { // fills x with n Arc Sine variates
+   
+      for ( size_t i = 0; i < n; i += BLOCK ) {
+         size_t m = std::min( BLOCK, n - i );
+         Real* y = x + i;
+         _uniforms( y, m );
+         for ( size_t j = 0; j < m; j++ ) {
+            Real q = vmath::sin( M_PI_2 * y[ j ] );
+            y[ j ] = xMin + ( xMax - xMin ) * q * q;
+         }
+      }
+   }
+   
+   Real beta( Real v, Real w,                    // Beta
+                Real xMin = 0., Real xMax = 1. ) { // (v > 0. and w > 0.)
 
       if ( v < w ) return xMax - ( xMax - xMin ) * beta( w, v );
-      double y1 = gamma( 0., 1., v );
-      double y2 = gamma( 0., 1., w );
+      Real y1 = gamma( 0., 1., v );
+      Real y2 = gamma( 0., 1., w );
       return xMin + ( xMax - xMin ) * y1 / ( y1 + y2 );
    }
    
-   double cauchy( double a = 0., double b = 1. ) { // Cauchy (or Lorentz)
+   void beta( Real x[], size_t n, Real v, Real w, Real xMin, Real xMax ) { // fills x with n Beta variates
+   
+      assert( v > 0. && w > 0. );
+      
+      gamma_param gv( v ), gw( w );
+      Real t[ BLOCK ];
+      for ( size_t i = 0; i < n; i += BLOCK ) {
+         size_t m = std::min( BLOCK, n - i );
+         Real* y = x + i;
+         for ( size_t j = 0; j < m; j++ ) y[ j ] = gamma( gv );
+         for ( size_t j = 0; j < m; j++ ) t[ j ] = gamma( gw );
+         for ( size_t j = 0; j < m; j++ ) y[ j ] = xMin + ( xMax - xMin ) * y[ j ] / ( y[ j ] + t[ j ] );
+      }
+   }
+   
+   Real cauchy( Real a = 0., Real b = 1. ) { // Cauchy (or Lorentz)
 
       // a is the location parameter and b is the scale parameter
       // b is the half width at half maximum (HWHM) and variance doesn't exist
@@ -99,218 +442,459 @@ public:
       
       return a + b * tan( M_PI * uniform( -0.5, 0.5 ) );
    }
+   
+   void cauchy( Real x[], size_t n, Real a, Real b ) { // fills x with n Cauchy variates
+   
+      assert( b > 0. );
+      
+      for ( size_t i = 0; i < n; i += BLOCK ) {
+         size_t m = std::min( BLOCK, n - i );
+         Real* y = x + i;
+         _uniforms( y, m );
+         for ( size_t j = 0; j < m; j++ ) y[ j ] = a + b * vmath::tan( M_PI * ( y[ j ] - 0.5 ) );
+      }
+   }
 
-   double chiSquare( int df ) { // Chi-Square
+   Real chiSquare( int df ) { // Chi-Square
       
       assert( df >= 1 );
       
-      return gamma( 0., 2., 0.5 * double( df ) );
+      return gamma( 0., 2., 0.5 * Real( df ) );
+   }
+   
+   void chiSquare( Real x[], size_t n, int df ) { // fills x with n Chi-Square variates
+      
+      assert( df >= 1 );
+      
+      gamma( x, n, 0., 2., 0.5 * Real( df ) );
    }
 
-   double cosine( double xMin = 0., double xMax = 1. ) { // Cosine
+   Real cosine( Real xMin = 0., Real xMax = 1. ) { // Cosine
    
       assert( xMin < xMax );
    
-      double a = 0.5 * ( xMin + xMax );    // location parameter
-      double b = ( xMax - xMin ) / M_PI;   // scale parameter
+      Real a = 0.5 * ( xMin + xMax );    // location parameter
+      Real b = ( xMax - xMin ) / M_PI;   // scale parameter
    
       return a + b * asin( uniform( -1., 1. ) );
    }
    
-   double doubleLog( double xMin = -1., double xMax = 1. ) { // Double Log
+   void cosine( Real x[], size_t n, Real xMin, Real xMax ) { // fills x with n Cosine variates
+   
+      assert( xMin < xMax );
+   
+      Real a = 0.5 * ( xMin + xMax );    // location parameter
+      Real b = ( xMax - xMin ) / M_PI;   // scale parameter
+      for ( size_t i = 0; i < n; i += BLOCK ) {
+         size_t m = std::min( BLOCK, n - i );
+         Real* y = x + i;
+         _uniforms( y, m );
+         for ( size_t j = 0; j < m; j++ ) y[ j ] = a + b * vmath::asin( 2. * y[ j ] - 1. );
+      }
+   }
+   
+   Real doubleLog( Real xMin = -1., Real xMax = 1. ) { // Double Log
 
       assert( xMin < xMax );
    
-      double a = 0.5 * ( xMin + xMax );    // location parameter
-      double b = 0.5 * ( xMax - xMin );    // scale parameter
+      Real a = 0.5 * ( xMin + xMax );    // location parameter
+      Real b = 0.5 * ( xMax - xMin );    // scale parameter
+   
+      if ( _coin() ) return a + b * _ur() * _ur();
+      else           return a - b * _ur() * _ur();
+   }
+   
+   void doubleLog( Real x[], size_t n, Real xMin, Real xMax ) { // fills x with n Double Log variates
    
-      if ( bernoulli( 0.5 ) ) return a + b * _u() * _u();
-      else                    return a - b * _u() * _u();
+      assert( xMin < xMax );
+   
+      Real a = 0.5 * ( xMin + xMax );    // location parameter
+      Real b = 0.5 * ( xMax - xMin );    // scale parameter
+      Real t[ BLOCK ];
+      uint64_t c[ BLOCK / 64 ];
+      for ( size_t i = 0; i < n; i += BLOCK ) {
+         size_t m = std::min( BLOCK, n - i );
+         Real* y = x + i;
+         _uniforms( y, m );
+         _uniforms( t, m );
+         _engine::fill64( _gen, c, ( m + 63 ) / 64 );   // the coins, a bit each
+         for ( size_t j = 0; j < m; j++ ) y[ j ] = a + ( ( c[ j >> 6 ] >> ( j & 63 ) ) & 1 ? b : -b ) * y[ j ] * t[ j ];
+      }
    }
 
-   double erlang( double b, int c ) { // Erlang (b > 0. and c >= 1)
+   Real erlang( Real b, int c ) { // Erlang (b > 0. and c >= 1)
 
       assert( b > 0. && c >= 1 );
   
-      double prod = 1.;
-      for ( int i = 0; i < c; i++ ) prod *= _u();
+      return gamma( 0., b, Real( c ) );   // the sum of c exponentials, in constant time and without underflow
+   }
+   
+   void erlang( Real x[], size_t n, Real b, int c ) { // fills x with n Erlang variates
+   
+      assert( b > 0. && c >= 1 );
       
-      return -b * log( prod );
+      gamma( x, n, 0., b, Real( c ) );
    }
    
-   double exponential( double a = 0., double c = 1. ) { // Exponential
+   Real exponential( Real a = 0., Real c = 1. ) { // Exponential
                                                     // location a, shape c
       assert( c > 0.0 );
    
-      return a - c * log( _u() );
+      return a + c * _exp();
    }
    
-   double extremeValue( double a = 0., double c = 1. ) { // Extreme Value
+   void exponential( Real x[], size_t n, Real a, Real c ) { // fills x with n Exponential variates
+   
+      assert( c > 0. );
+      
+      for ( size_t i = 0; i < n; i += BLOCK ) {
+         size_t m = std::min( BLOCK, n - i );
+         Real* y = x + i;
+         _exps( y, m );
+         for ( size_t j = 0; j < m; j++ ) y[ j ] = a + c * y[ j ];
+      }
+   }
+   
+   Real extremeValue( Real a = 0., Real c = 1. ) { // Extreme Value
                                                      // location a, shape c
       assert( c > 0. );
    
-      return a + c * log( -log( _u() ) );
+      return a + c * log( _exp() );
+   }
+   
+   void extremeValue( Real x[], size_t n, Real a, Real c ) { // fills x with n Extreme Value variates
+   
+      assert( c > 0. );
+      
+      for ( size_t i = 0; i < n; i += BLOCK ) {
+         size_t m = std::min( BLOCK, n - i );
+         Real* y = x + i;
+         _exps( y, m );
+         for ( size_t j = 0; j < m; j++ ) y[ j ] = a + c * vmath::log( y[ j ] );
+      }
    }
    
-   double fRatio( int v, int w ) { // F Ratio (v and w >= 1)
+   Real fRatio( int v, int w ) { // F Ratio (v and w >= 1)
 
       assert( v >= 1 && w >= 1 );
    
       return ( chiSquare( v ) / v ) / ( chiSquare( w ) / w );
    }
    
-   double gamma( double a, double b, double c ) { // Gamma
+   void fRatio( Real x[], size_t n, int v, int w ) { // fills x with n F Ratio variates
+   
+      assert( v >= 1 && w >= 1 );
+      
+      Real t[ BLOCK ];
+      for ( size_t i = 0; i < n; i += BLOCK ) {
+         size_t m = std::min( BLOCK, n - i );
+         Real* y = x + i;
+         chiSquare( y, m, v );
+         chiSquare( t, m, w );
+         for ( size_t j = 0; j < m; j++ ) y[ j ] = ( y[ j ] / v ) / ( t[ j ] / w );
+      }
+   }
+   
+   Real gamma( Real a, Real b, Real c ) { // Gamma
                                                  // location a, scale b, shape c
       assert( b > 0. && c > 0. );
    
-      if ( c < 1. ) {
-         const double C = 1. + c / M_E;
-         while ( true ) {
-            double p = C * _u();      
-            if ( p > 1. ) {
-               double y = -log( ( C - p ) / c );
-               if ( _u() <= pow( y, c - 1. ) ) return a + b * y;
-            }
-            else {
-               double y = pow( p, 1. / c );
-               if ( _u() <= exp( -y ) ) return a + b * y;
-            }
-         }
+      if ( c == 1.0 ) return exponential( a, b );
+      return gamma( gamma_param( c ), a, b );
+   }
+   
+   Real gamma( const gamma_param& g, Real a = 0., Real b = 1. ) { // Gamma, with the constants for shape g.c
+                                                                      // location a, scale b
+      // Ref: Marsaglia, G. and W. W. Tsang, "A Simple Method for Generating Gamma Variables,"
+      //      ACM Transactions on Mathematical Software, Vol. 26, No. 3, pp. 363-372, 2000.
+      // y = d (1 + k x)^3 for a normal x, accepted about 98% of the time, mostly by the squeeze without a log
+      
+      assert( b > 0. );
+      
+      double x, v, u;   // in double whatever Real is, like the other rejection methods
+      while ( true ) {
+         do {
+            x = _normal == ZIGGURAT_NORMAL ? _zigguratNormal() : double( normal() );
+            v = 1. + g.k * x;
+         } while ( v <= 0. );
+         v = v * v * v;
+         u = _u();
+         double x2 = x * x;
+         if ( u < 1. - 0.0331 * x2 * x2 ) break;
+         if ( log( u ) < 0.5 * x2 + g.d * ( 1. - v + log( v ) ) ) break;
       }
-      else if ( c == 1.0 ) return exponential( a, b );
-      else {
-         const double A = 1. / sqrt( 2. * c - 1. );
-         const double B = c - log( 4. );
-         const double Q = c + 1. / A;
-         const double T = 4.5;
-         const double D = 1. + log( T );
-         while ( true ) {
-            double p1 = _u();
-            double p2 = _u();
-            double v = A * log( p1 / ( 1. - p1 ) );
-            double y = c * exp( v );
-            double z = p1 * p1 * p2;
-            double w = B + Q * v - y;
-            if ( w + D - T * z >= 0. || w >= log( z ) ) return a + b * y;
-         }
+      double y = g.d * v;
+      if ( g.c < 1. ) y *= exp( -_exp() * g.inv_c );   // boost: u^(1/c) = exp( log(u) / c ), which does not underflow to 0 early
+      return a + b * y;
+   }
+   
+   void gamma( Real x[], size_t n, Real a, Real b, Real c ) { // fills x with n Gamma variates, sharing one setup
+   
+      assert( b > 0. && c > 0. );
+   
+      if ( c == 1.0 ) {
+         exponential( x, n, a, b );
+         return;
       }
+      gamma_param g( c );
+      for ( size_t i = 0; i < n; i++ ) x[ i ] = gamma( g, a, b );
    }
    
-   double laplace( double a = 0., double b = 1. ) { // Laplace
+   Real laplace( Real a = 0., Real b = 1. ) { // Laplace
                                                 // (or double exponential)
       assert( b > 0. );
 
       // composition method
   
-      if ( bernoulli( 0.5 ) ) return a + b * log( _u() );
-      else                    return a - b * log( _u() );
+      if ( _coin() ) return a - b * _exp();
+      else           return a + b * _exp();
+   }
+   
+   void laplace( Real x[], size_t n, Real a, Real b ) { // fills x with n Laplace variates
+   
+      assert( b > 0. );
+      
+      uint64_t c[ BLOCK / 64 ];
+      for ( size_t i = 0; i < n; i += BLOCK ) {
+         size_t m = std::min( BLOCK, n - i );
+         Real* y = x + i;
+         _exps( y, m );
+         _engine::fill64( _gen, c, ( m + 63 ) / 64 );   // the coins, a bit each
+         for ( size_t j = 0; j < m; j++ ) y[ j ] = a + ( ( c[ j >> 6 ] >> ( j & 63 ) ) & 1 ? -b : b ) * y[ j ];
+      }
    }
    
-   double logarithmic( double xMin = 0., double xMax = 1. ) { // Logarithmic
+   Real logarithmic( Real xMin = 0., Real xMax = 1. ) { // Logarithmic
 
       assert( xMin < xMax );
    
-      double a = xMin;          // location parameter
-      double b = xMax - xMin;   // scale parameter
+      Real a = xMin;          // location parameter
+      Real b = xMax - xMin;   // scale parameter
    
       // use convolution formula for product of two IID uniform variates
 
-      return a + b * _u() * _u();
+      return a + b * _ur() * _ur();
+   }
+   
+   void logarithmic( Real x[], size_t n, Real xMin, Real xMax ) { // fills x with n Logarithmic variates
+   
+      assert( xMin < xMax );
+      
+      Real t[ BLOCK ];
+      for ( size_t i = 0; i < n; i += BLOCK ) {
+         size_t m = std::min( BLOCK, n - i );
+         Real* y = x + i;
+         _uniforms( y, m );
+         _uniforms( t, m );
+         for ( size_t j = 0; j < m; j++ ) y[ j ] = xMin + ( xMax - xMin ) * y[ j ] * t[ j ];
+      }
    }
    
-   double logistic( double a = 0., double c = 1. ) { // Logistic
+   Real logistic( Real a = 0., Real c = 1. ) { // Logistic
 
       assert( c > 0. );
 
-      return a - c * log( 1. / _u() - 1. );
+      return a - c * log( 1. / _uro() - 1. );
+   }
+   
+   void logistic( Real x[], size_t n, Real a, Real c ) { // fills x with n Logistic variates
+   
+      assert( c > 0. );
+      
+      for ( size_t i = 0; i < n; i += BLOCK ) {
+         size_t m = std::min( BLOCK, n - i );
+         Real* y = x + i;
+         _uniformsOpen( y, m );
+         for ( size_t j = 0; j < m; j++ ) y[ j ] = a - c * vmath::log( 1. / y[ j ] - 1. );
+      }
    }
    
-   double lognormal( double a, double mu, double sigma ) { // Lognormal
+   Real lognormal( Real a, Real mu, Real sigma ) { // Lognormal
 
       return a + exp( normal( mu, sigma ) );
    }
    
-   double normal( double mu = 0., double sigma = 1. ) { // Normal
+   void lognormal( Real x[], size_t n, Real a, Real mu, Real sigma ) { // fills x with n Lognormal variates
+   
+      for ( size_t i = 0; i < n; i += BLOCK ) {
+         size_t m = std::min( BLOCK, n - i );
+         Real* y = x + i;
+         normal( y, m, mu, sigma );
+         for ( size_t j = 0; j < m; j++ ) y[ j ] = a + vmath::exp( y[ j ] );
+      }
+   }
+   
+   Real normal( Real mu = 0., Real sigma = 1. ) { // Normal
 
       assert( sigma > 0. );
+      
+      if ( _normal == ZIGGURAT_NORMAL ) return mu + sigma * _zigguratNormal();
    
-      static bool f = true;
-      static double p2, q;
-      double p1, p;
+      Real p1, p;
    
-      if ( f ) {
+      if ( !_polar ) {
          do {
             p1 = uniform( -1., 1. );
-            p2 = uniform( -1., 1. );
-            p = p1 * p1 + p2 * p2;
+            _p2 = uniform( -1., 1. );
+            p = p1 * p1 + _p2 * _p2;
          } while ( p >= 1. );
-         f = false;
-         q = sqrt( -2. * log( p ) / p );
-         return mu + sigma * p1 * q;
+         _polar = true;
+         _q = sqrt( -2. * log( p ) / p );
+         return mu + sigma * p1 * _q;
       }
-      f = true;
-      return mu + sigma * p2 * q;
+      _polar = false;
+      return mu + sigma * _p2 * _q;
+   }
+   
+   void normal( Real x[], size_t n, Real mu, Real sigma ) { // fills x with n Normal variates
+   
+      assert( sigma > 0. );
+      
+      if ( _normal == ZIGGURAT_NORMAL )
+         for ( size_t i = 0; i < n; i++ ) x[ i ] = mu + sigma * _zigguratNormal();
+      else
+         for ( size_t i = 0; i < n; i++ ) x[ i ] = normal( mu, sigma );
    }
    
-   double parabolic( double xMin = 0., double xMax = 1. ) { // Parabolic
+   Real parabolic( Real xMin = 0., Real xMax = 1. ) { // Parabolic
   
       assert( xMin < xMax );
    
-      double a    = 0.5 * ( xMin + xMax );        // location parameter
-      double yMax = _parabola( a, xMin, xMax );   // maximum function range
+      Real a    = 0.5 * ( xMin + xMax );        // location parameter
+      Real yMax = _parabola( a, xMin, xMax );   // maximum function range
    
       return userSpecified( _parabola, xMin, xMax, 0., yMax );
    }
    
-   double pareto( double c ) { // Pareto
+   void parabolic( Real x[], size_t n, Real xMin, Real xMax ) { // fills x with n Parabolic variates
+   
+      for ( size_t i = 0; i < n; i++ ) x[ i ] = parabolic( xMin, xMax );
+   }
+   
+   Real pareto( Real c ) { // Pareto
                                // shape c
       assert( c > 0. );
    
-      return pow( _u(), -1. / c );
+      return pow( _uro(), -1. / c );
    }
    
-   double pearson5( double b, double c ) { // Pearson Type 5
+   void pareto( Real x[], size_t n, Real c ) { // fills x with n Pareto variates
+   
+      assert( c > 0. );
+      
+      Real e = -1. / c;
+      for ( size_t i = 0; i < n; i += BLOCK ) {
+         size_t m = std::min( BLOCK, n - i );
+         Real* y = x + i;
+         _uniformsOpen( y, m );
+         for ( size_t j = 0; j < m; j++ ) y[ j ] = vmath::pow( y[ j ], e );
+      }
+   }
+   
+   Real pearson5( Real b, Real c ) { // Pearson Type 5
                                            // scale b, shape c
       assert( b > 0. && c > 0. );
    
       return 1. / gamma( 0., 1. / b, c );
    }
    
-   double pearson6( double b, double v, double w ) { // Pearson Type 6
+   void pearson5( Real x[], size_t n, Real b, Real c ) { // fills x with n Pearson Type 5 variates
+   
+      assert( b > 0. && c > 0. );
+      
+      gamma( x, n, 0., 1. / b, c );
+      for ( size_t i = 0; i < n; i++ ) x[ i ] = 1. / x[ i ];
+   }
+   
+   Real pearson6( Real b, Real v, Real w ) { // Pearson Type 6
                                                      // scale b, shape v & w
       assert( b > 0. && v > 0. && w > 0. );
    
       return gamma( 0., b, v ) / gamma( 0., b, w );
    }
    
-   double power( double c ) { // Power
+   void pearson6( Real x[], size_t n, Real b, Real v, Real w ) { // fills x with n Pearson Type 6 variates
+   
+      assert( b > 0. && v > 0. && w > 0. );
+      
+      gamma_param gv( v ), gw( w );
+      Real t[ BLOCK ];
+      for ( size_t i = 0; i < n; i += BLOCK ) {
+         size_t m = std::min( BLOCK, n - i );
+         Real* y = x + i;
+         for ( size_t j = 0; j < m; j++ ) y[ j ] = gamma( gv );
+         for ( size_t j = 0; j < m; j++ ) t[ j ] = gamma( gw );
+         for ( size_t j = 0; j < m; j++ ) y[ j ] /= t[ j ];   // the scale b cancels
+      }
+   }
+   
+   Real power( Real c ) { // Power
                               // shape c
       assert( c > 0. );
    
-      return pow( _u(), 1. / c );
+      return pow( _ur(), 1. / c );
    }
    
-   double rayleigh( double a, double b ) { // Rayleigh
+   void power( Real x[], size_t n, Real c ) { // fills x with n Power variates
+   
+      assert( c > 0. );
+      
+      Real e = 1. / c;
+      for ( size_t i = 0; i < n; i += BLOCK ) {
+         size_t m = std::min( BLOCK, n - i );
+         Real* y = x + i;
+         _uniforms( y, m );
+         for ( size_t j = 0; j < m; j++ ) y[ j ] = vmath::pow( y[ j ], e );
+      }
+   }
+   
+   Real rayleigh( Real a, Real b ) { // Rayleigh
                                            // location a, scale b
       assert( b > 0. );
    
-      return a + b * sqrt( -log( _u() ) );
+      return a + b * sqrt( _exp() );
+   }
+   
+   void rayleigh( Real x[], size_t n, Real a, Real b ) { // fills x with n Rayleigh variates
+   
+      assert( b > 0. );
+      
+      for ( size_t i = 0; i < n; i += BLOCK ) {
+         size_t m = std::min( BLOCK, n - i );
+         Real* y = x + i;
+         _exps( y, m );
+         for ( size_t j = 0; j < m; j++ ) y[ j ] = a + b * sqrt( y[ j ] );
+      }
    }
    
-   double studentT( int df ) { // Student's T
+   Real studentT( int df ) { // Student's T
                                // degres of freedom df
       assert( df >= 1 );
    
       return normal() / sqrt( chiSquare( df ) / df );
    }
    
-   double triangular( double xMin = 0.,     // Triangular
-                      double xMax = 1.,     // with default interval [0,1)
-                      double c    = 0.5 ) { // and default mode 0.5
+   void studentT( Real x[], size_t n, int df ) { // fills x with n Student's T variates
+   
+      assert( df >= 1 );
+      
+      Real t[ BLOCK ];
+      for ( size_t i = 0; i < n; i += BLOCK ) {
+         size_t m = std::min( BLOCK, n - i );
+         Real* y = x + i;
+         normal( y, m, 0., 1. );
+         chiSquare( t, m, df );
+         for ( size_t j = 0; j < m; j++ ) y[ j ] /= sqrt( t[ j ] / df );
+      }
+   }
+   
+   Real triangular( Real xMin = 0.,     // Triangular
+                      Real xMax = 1.,     // with default interval [0,1)
+                      Real c    = 0.5 ) { // and default mode 0.5
 
       assert( xMin < xMax && xMin <= c && c <= xMax );
       
-      double p = _u(), q = 1. - p;
+      Real p = _ur(), q = 1. - p;
       
       if ( p <= ( c - xMin ) / ( xMax - xMin ) )
          return xMin + sqrt( ( xMax - xMin ) * ( c - xMin ) * p );
@@ -318,24 +902,54 @@ public:
          return xMax - sqrt( ( xMax - xMin ) * ( xMax - c ) * q );
    }
    
-   double uniform( double xMin = 0., double xMax = 1. ) { // Uniform
+   void triangular( Real x[], size_t n, Real xMin, Real xMax, Real c ) { // fills x with n Triangular variates
+   
+      assert( xMin < xMax && xMin <= c && c <= xMax );
+      
+      Real pc = ( c - xMin ) / ( xMax - xMin );
+      Real l  = ( xMax - xMin ) * ( c - xMin ), r = ( xMax - xMin ) * ( xMax - c );
+      for ( size_t i = 0; i < n; i += BLOCK ) {
+         size_t m = std::min( BLOCK, n - i );
+         Real* y = x + i;
+         _uniforms( y, m );
+         for ( size_t j = 0; j < m; j++ ) {   // both branches, then a select, so that the loop has no jumps
+            Real p = y[ j ];
+            Real lo = xMin + sqrt( l * p ), hi = xMax - sqrt( r * ( 1. - p ) );
+            y[ j ] = p <= pc ? lo : hi;
+         }
+      }
+   }
+   
+   Real uniform( Real xMin = 0., Real xMax = 1. ) { // Uniform
                                                           // on [xMin,xMax)
       assert( xMin < xMax );
    
-      return xMin + ( xMax - xMin ) * _u();
+      return xMin + ( xMax - xMin ) * _ur();
+   }
+   
+   void uniform( Real x[], size_t n, Real xMin, Real xMax ) { // fills x with n Uniform variates
+   
+      assert( xMin < xMax );
+      
+      for ( size_t i = 0; i < n; i += BLOCK ) {
+         size_t m = std::min( BLOCK, n - i );
+         Real* y = x + i;
+         _uniforms( y, m );
+         for ( size_t j = 0; j < m; j++ ) y[ j ] = xMin + ( xMax - xMin ) * y[ j ];
+      }
    }
    
-   double userSpecified(                // User-Specified Distribution
-        double( *usf )(                 // pointer to user-specified function
-             double,                    // x
-             double,                    // xMin
-             double ),                  // xMax
-        double xMin, double xMax,       // function domain
-        double yMin, double yMax ) {    // function range
+   Real userSpecified(                // User-Specified Distribution
+        Real( *usf )(                 // pointer to user-specified function
+             Real,                    // x
+             Real,                    // xMin
+             Real ),                  // xMax
+        Real xMin, Real xMax,       // function domain
+        Real yMin, Real yMax ) {    // function range
 
       assert( xMin < xMax && yMin < yMax );
    
-      double x, y, areaMax = ( xMax - xMin ) * ( yMax - yMin ); 
+      Real x, y, areaMax = ( xMax - xMin ) * ( yMax - yMin ); 
 
       // acceptance-rejection method
    
@@ -348,11 +962,24 @@ public:
       return x;
    }
    
-   double weibull( double a, double b, double c ) { // Weibull
+   Real weibull( Real a, Real b, Real c ) { // Weibull
                                                     // location a, scale b,
       assert( b > 0. && c > 0. );                   // shape c
    
-      return a + b * pow( -log( _u() ), 1. / c );
+      return a + b * pow( _exp(), 1. / c );
+   }
+   
+   void weibull( Real x[], size_t n, Real a, Real b, Real c ) { // fills x with n Weibull variates
+   
+      assert( b > 0. && c > 0. );
+      
+      Real e = 1. / c;
+      for ( size_t i = 0; i < n; i += BLOCK ) {
+         size_t m = std::min( BLOCK, n - i );
+         Real* y = x + i;
+         _exps( y, m );
+         for ( size_t j = 0; j < m; j++ ) y[ j ] = a + b * vmath::pow( y[ j ], e );
+      }
    }
                    
 // Discrete Distributions
@@ -361,36 +988,105 @@ public:
    
       assert( 0. <= p && p <= 1. );
    
-      return _u() < p;
+      // compare the bits of a uniform u, drawn lazily from the coin reservoir, with the binary expansion of p:
+      // the first place where they differ decides u < p, after 2 bits on average (exactly 1 for p = 1/2)
+      
+      if ( p >= 1. ) return true;
+      while ( p > 0. ) {
+         p += p;                  // exact, shifts the next bit of p into the units place
+         bool d = p >= 1.;
+         if ( d ) p -= 1.;
+         if ( _coin() != d ) return d;
+      }
+      return false;   // the rest of p is 0, so u >= p
+   }
+   
+   void bernoulli( bool x[], size_t n, double p ) { // fills x with n Bernoulli Trials
+   
+      assert( 0. <= p && p <= 1. );
+      
+      if ( p == 0.5 ) {   // one bit each, straight from whole words
+         uint64_t c[ BLOCK / 64 ];
+         for ( size_t i = 0; i < n; i += BLOCK ) {
+            size_t m = std::min( BLOCK, n - i );
+            _engine::fill64( _gen, c, ( m + 63 ) / 64 );
+            for ( size_t j = 0; j < m; j++ ) x[ i + j ] = ( c[ j >> 6 ] >> ( j & 63 ) ) & 1;
+         }
+      }
+      else for ( size_t i = 0; i < n; i++ ) x[ i ] = bernoulli( p );
    }
    
    int binomial( int n, double p ) { // Binomial
 
       assert( n >= 1 && 0. <= p && p <= 1. );
    
-      int sum = 0;
-      for ( int i = 0; i < n; i++ ) sum += bernoulli( p );
-      return sum;
+      return binomial( binomial_param( n, p ) );
+   }
+   
+   int binomial( const binomial_param& g ) { // Binomial, with the constants for g.n and g.p
+
+      if ( g.p == 0.5 && g.n <= N_COINS ) return _countCoins( g.n );   // heads in g.n fair coins
+      
+      int k = g.btrs ? _btrs( g ) : _binomialInversion( g );
+      return g.flip ? g.n - k : k;
+   }
+   
+   void binomial( int x[], size_t n, int trials, double p ) { // fills x with n Binomial variates, sharing one setup
+   
+      binomial_param g( trials, p );
+      for ( size_t i = 0; i < n; i++ ) x[ i ] = binomial( g );
+   }
+   
+   int discrete( const alias_table& t ) { // Discrete, on 0 to t.size() - 1 with the weights of the table
+   
+      uint64_t b = _engine::rng64( _gen );
+      uint64_t i = ( ( b >> 32 ) * uint64_t( t.size() ) ) >> 32;   // column from the high half
+      return ( b & 0xffffffff ) < t.threshold[ i ] ? int( i ) : t.alias[ i ];
+   }
+   
+   void discrete( int x[], size_t n, const alias_table& t ) { // fills x with n Discrete variates from the table
+   
+      for ( size_t i = 0; i < n; i++ ) x[ i ] = discrete( t );
    }
    
    int geometric( double p ) { // Geometric
 
       assert( 0. < p && p < 1. );
 
-      return int( log( _u() ) / log( 1. - p ) );
+      return int( _exp() / -log( 1. - p ) );
+   }
+   
+   void geometric( int x[], size_t n, double p ) { // fills x with n Geometric variates
+   
+      assert( 0. < p && p < 1. );
+      
+      double e[ BLOCK ], s = -1. / log( 1. - p );
+      for ( size_t i = 0; i < n; i += BLOCK ) {
+         size_t m = std::min( BLOCK, n - i );
+         _exps( e, m );
+         for ( size_t j = 0; j < m; j++ ) x[ i + j ] = int( e[ j ] * s );
+      }
    }
    
    int hypergeometric( int n, int N, int K ) {          // Hypergeometric
                                                         // trials n, size N,
       assert( 0 <= n && n <= N && N >= 1 && K >= 0 );   // successes K
       
-      int count = 0;
-      for ( int i = 0; i < n; i++, N-- ) {
+      return hypergeometric( hypergeometric_param( n, N, K ) );
+   }
    
-         double p = double( K ) / double( N );
-         if ( bernoulli( p ) ) { count++; K--; }
-      }
-      return count;
+   int hypergeometric( const hypergeometric_param& g ) { // Hypergeometric, with the constants for g.n, g.N and g.K
+   
+      int k = g.hrua ? _hrua( g ) : _hypergeometricInversion( g );
+      if ( g.ks < g.K ) k = g.ns - k;   // undo the symmetries: successes for failures
+      if ( g.ns < g.n ) k = g.K - k;    // and the items left for those drawn
+      return k;
+   }
+   
+   void hypergeometric( int x[], size_t n, int trials, int N, int K ) { // fills x with n Hypergeometric variates, sharing one setup
+   
+      hypergeometric_param g( trials, N, K );
+      for ( size_t i = 0; i < n; i++ ) x[ i ] = hypergeometric( g );
    }
    
    void multinomial( int    n,            // Multinomial
@@ -403,33 +1099,50 @@ public:
       for ( int bin = 0; bin < m; bin++ ) sum += p[ bin ];    // probabilities
       assert( sum == 1. );                                    // must sum to 1
       
-      for ( int bin = 0; bin < m; bin++ ) count[ bin ] = 0;   // initialize
-   
-      // generate n uniform variates in the interval [0,1) and bin the results
-   
-      for ( int i = 0; i < n; i++ ) {
-
-         double lower = 0., upper = 0., u = _u();
-
-         for ( int bin = 0; bin < m; bin++ ) {
-
-         // locate subinterval, which is of length p[ bin ],
-         // that contains the variate and increment the corresponding counter
+      // draw each count in turn as a binomial conditioned on the trials and probability left by the bins before it,
+      // which takes at most m - 1 binomial variates however large n is
       
-            lower = upper;
-            upper += p[ bin ];
-            if ( lower <= u && u < upper ) { count[ bin ]++; break; }
-         }
+      double mass = 1.;   // probability of the bins not yet drawn
+      for ( int bin = 0; bin < m - 1; bin++ ) {
+      
+         if ( n == 0 || mass <= 0. ) count[ bin ] = 0;
+         else count[ bin ] = binomial( n, std::min( p[ bin ] / mass, 1. ) );
+         n    -= count[ bin ];
+         mass -= p[ bin ];
       }
+      count[ m - 1 ] = n;
+   }
+   
+   void multinomial( int                n,            // Multinomial
+                     const alias_table& t,            // trials n, alias table t of the probabilities,
+                     int                count[] ) {   // success vector count, one per event of t
+      
+      // n lookups in the alias table, for when n is much smaller than the number of events
+      
+      for ( int bin = 0; bin < t.size(); bin++ ) count[ bin ] = 0;
+      for ( int i = 0; i < n; i++ ) count[ discrete( t ) ]++;
    }
    
-   int negativeBinomial( int s, double p ) { // Negative Binomial
-                                             // successes s, probability p
-      assert( s >= 1 && 0. < p && p < 1. );
+   int negativeBinomial( double s, double p ) { // Negative Binomial
+                                                // successes s > 0, not necessarily an integer, probability p
+      assert( s > 0. && 0. < p && p < 1. );
+   
+      // gamma-Poisson mixture: a Poisson variate whose mean is gamma with shape s and scale (1 - p) / p
+   
+      double mu = gamma( 0., ( 1. - p ) / p, s );
+      return mu > 0. ? poisson( mu ) : 0;
+   }
    
-      int sum = 0;
-      for ( int i = 0; i < s; i++ ) sum += geometric( p );
-      return sum;
+   void negativeBinomial( int x[], size_t n, double s, double p ) { // fills x with n Negative Binomial variates
+   
+      assert( s > 0. && 0. < p && p < 1. );
+      
+      gamma_param g( s );
+      double b = ( 1. - p ) / p;
+      for ( size_t i = 0; i < n; i++ ) {
+         double mu = gamma( g, 0., b );
+         x[ i ] = mu > 0. ? poisson( mu ) : 0;
+      }
    }
    
    int pascal( int s, double p ) { // Pascal
@@ -437,32 +1150,56 @@ public:
       return negativeBinomial( s, p ) + s;
    }
    
+   void pascal( int x[], size_t n, int s, double p ) { // fills x with n Pascal variates
+   
+      negativeBinomial( x, n, double( s ), p );
+      for ( size_t i = 0; i < n; i++ ) x[ i ] += s;
+   }
+   
    int poisson( double mu ) { // Poisson
 
       assert ( mu > 0. );
    
-      double a = exp( -mu );
-      double b = 1.;
+      return poisson( poisson_param( mu ) );
+   }
+   
+   int poisson( const poisson_param& g ) { // Poisson, with the constants for mean g.mu
+   
+      return g.ptrs ? _ptrs( g ) : _poissonInversion( g );
+   }
+   
+   void poisson( int x[], size_t n, double mu ) { // fills x with n Poisson variates of mean mu, sharing one setup
    
-      int i;
-      for ( i = 0; b >= a; i++ ) b *= _u();   
-      return i - 1;
+      poisson_param g( mu );
+      for ( size_t i = 0; i < n; i++ ) x[i] = poisson( g );
    }
    
    int uniformDiscrete( int i, int j ) { // Uniform Discrete
                                          // inclusive i to j
       assert( i < j );
 
-      return i + int( ( j - i + 1 ) * _u() );
+      return int( uint32_t( i ) + _bounded( uint32_t( j ) - uint32_t( i ) + 1 ) );   // span in unsigned, so no overflow
+   }
+   
+   void uniformDiscrete( int x[], size_t n, int i, int j ) { // fills x with n Uniform Discrete variates
+   
+      assert( i < j );
+      
+      uint32_t b[ BLOCK ], range = uint32_t( j ) - uint32_t( i ) + 1;
+      for ( size_t k = 0; k < n; k += BLOCK ) {
+         size_t m = std::min( BLOCK, n - k );
+         if ( range == 0 ) _engine::fill32( _gen, b, m );   // the whole of int
+         else              _engine::get( _gen ).fill32_bounded( b, m, range );
+         for ( size_t l = 0; l < m; l++ ) x[ k + l ] = int( uint32_t( i ) + b[ l ] );
+      }
    }
 
 // Empirical and Data-Driven Distributions
 
    double empirical( void ) { // Empirical Continuous
 
-      static std::vector< double > x, cdf;
-      static int              n;
-      static bool             init = false;
+      empirical_table& t = _empirical.t;
+      bool&            init = _empirical.init;
    
       if ( !init ) {
          std::ifstream in( "empiricalDistribution" );
@@ -470,35 +1207,38 @@ public:
             std::cerr << "Cannot open \"empiricalDistribution\" input file" << std::endl;
             exit( 1 );
          }
+         std::vector< double > x, cdf;
          double value, prob;
          while ( in >> value >> prob ) {   // read in empirical distribution
             x.push_back( value );
             cdf.push_back( prob );
          }
-         n = x.size();
+         t.build( x, cdf );
          init = true;
-      
-         // check that this is indeed a cumulative distribution
-
-         assert( 0. == cdf[ 0 ] && cdf[ n - 1 ] == 1. );
-         for ( int i = 1; i < n; i++ ) assert( cdf[ i - 1 ] < cdf[ i ] );
       }
 
-      double p = _u();
-      for ( int i = 0; i < n - 1; i++ )
-         if ( cdf[ i ] <= p && p < cdf[ i + 1 ] )
-            return x[ i ] + ( x[ i + 1 ] - x[ i ] ) *
-                            ( p - cdf[ i ] ) / ( cdf[ i + 1 ] - cdf[ i ] );
-      return x[ n - 1 ];
+      return empirical( t );
+   }
+   
+   double empirical( const empirical_table& t ) { // Empirical Continuous, from a compiled table
+   
+      return t.quantile( _u() );
+   }
+   
+   void empirical( double x[], size_t n, const empirical_table& t ) { // fills x with n variates from a compiled table
+   
+      for ( size_t i = 0; i < n; i += BLOCK ) {
+         size_t m = std::min( BLOCK, n - i );
+         _uniforms( x + i, m );
+         t.quantile( x + i, m );
+      }
    }
    
    int empiricalDiscrete( void ) { // Empirical Discrete
 
-      static std::vector< int >    k;
-      static std::vector< double > f[ 2 ];   // f[ 0 ] is pdf and f[ 1 ] is cdf
-      static double           max;
-      static int              n;
-      static bool             init = false;
+      std::vector< int >& k = _empiricalDiscrete.k;
+      alias_table&        t = _empiricalDiscrete.t;
+      bool&               init = _empiricalDiscrete.init;
    
       if ( !init ) {
          std::ifstream in ( "empiricalDiscrete" );
@@ -508,42 +1248,31 @@ public:
          }
          int value;
          double freq;
+         std::vector< double > f;
          while ( in >> value >> freq ) {   // read in empirical data
             k.push_back( value );
-            f[ 0 ].push_back( freq );
+            f.push_back( freq );
          }
-         n = k.size();
          init = true;
-   
-         // form the cumulative distribution
-
-         f[ 1 ].push_back( f[ 0 ][ 0 ] );
-         for ( int i = 1; i < n; i++ )
-            f[ 1 ].push_back( f[ 1 ][ i - 1 ] + f[ 0 ][ i ] );
 
          // check that the integer points are in ascending order
 
-         for ( int i = 1; i < n; i++ ) assert( k[ i - 1 ] < k[ i ] );
+         for ( unsigned int i = 1; i < k.size(); i++ ) assert( k[ i - 1 ] < k[ i ] );
       
-         max = f[ 1 ][ n - 1 ];
+         // build the alias table from the frequencies
+         
+         t.build( &f[ 0 ], f.size() );
       }
    
-      // select a uniform variate between 0 and the max value of the cdf
-
-      double p = uniform( 0., max );
-
-      // locate and return the corresponding index
-
-      for ( int i = 0; i < n; i++ ) if ( p <= f[ 1 ][ i ] ) return k[ i ];
-      return k[ n - 1 ];
+      return k[ discrete( t ) ];
    }
    
    double sample( bool replace = true ) { // Sample w or w/o replacement from a
                                           // distribution of 1-D data in a file
-      static std::vector< double > v;     // vector for sampling with replacement
-      static bool init = false;           // flag that file has been read in
-      static int n;                       // number of data elements in the file
-      static int index = 0;               // subscript in the sequential order
+      std::vector< double >& v = _sample.v;   // vector for sampling with replacement
+      bool& init = _sample.init;              // flag that file has been read in
+      int& n = _sample.n;                     // number of data elements in the file
+      int& index = _sample.index;             // subscript in the sequential order
    
       if ( !init ) {
          std::ifstream in( "sampleData" );
@@ -563,7 +1292,7 @@ public:
             //      Seminumerical Algorithms. London: Addison-Wesley, 1969.
 
             for ( int i = n - 1; i > 0; i-- ) {
-               int j = int( ( i + 1 ) * _u() );
+               int j = int( _bounded( i + 1 ) );
                std::swap( v[ i ], v[ j ] );
             }
          }
@@ -581,12 +1310,11 @@ public:
    
    void sample( double x[], int ndim ) { // Sample from a given distribution
                                          // of multi-dimensional data
-      static const int N_DIM = 6;
       assert( ndim <= N_DIM );
    
-      static std::vector< double > v[ N_DIM ];
-      static bool init = false;
-      static int n;
+      std::vector< double >* v = _sampleND.v;
+      bool& init = _sampleND.init;
+      int& n = _sampleND.n;
    
       if ( !init )  {
          std::ifstream in( "sampleData" );
@@ -626,11 +1354,11 @@ public:
    //       A Data Based Random Number Generator for A Multivariate Distribution
    //       - A User's Manual, ARBRL-TR-02439, BRL, APG, MD, Nov. 1982.
 
-      static std::vector<point2d> data;
-      static point2d              min, max;
-      static int                  m;
-      static double               lower, upper;
-      static bool                 init = false;
+      std::vector<point2d>& data = _stochastic.data;
+      point2d&              min = _stochastic.min, & max = _stochastic.max;
+      int&                  m = _stochastic.m;
+      double&               lower = _stochastic.lower, & upper = _stochastic.upper;
+      bool&                 init = _stochastic.init;
 
       if ( !init ) {
          std::ifstream in( "stochasticData" );
@@ -869,6 +1597,26 @@ public:
       return p;
    }
    
+   void spherical( point3d p[], size_t n,     // fills p with n Uniform Spherical variates
+                   double thMin, double thMax, double phMin, double phMax ) {
+
+      assert( 0. <= thMin && thMin < thMax && thMax <= M_PI &&
+              0. <= phMin && phMin < phMax && phMax <= 2. * M_PI );
+   
+      double c0 = cos( thMax ), c1 = cos( thMin );
+      double u[ BLOCK ], v[ BLOCK ];
+      for ( size_t i = 0; i < n; i += BLOCK ) {
+         size_t m = std::min( BLOCK, n - i );
+         _uniforms( u, m );
+         _uniforms( v, m );
+         for ( size_t j = 0; j < m; j++ ) u[ j ] = vmath::acos( c0 + ( c1 - c0 ) * u[ j ] );   // polar angle
+         for ( size_t j = 0; j < m; j++ ) {
+            p[ i + j ].theta = u[ j ];
+            p[ i + j ].phi   = phMin + ( phMax - phMin ) * v[ j ];                              // azimuth
+         }
+      }
+   }
+   
    void sphericalND( double x[], int n ) { // Uniform over the surface of
                                            // an n-dimensional unit sphere
 
@@ -897,22 +1645,17 @@ public:
    
    void avoidance( double x[], unsigned int ndim ) { // Maximal Avoidance (N-D)
 
-      static const unsigned int MAXBIT = 30;
-      static const unsigned int MAXDIM = 6;
-   
       assert( ndim <= MAXDIM );
 
-      static unsigned long ix[ MAXDIM + 1 ] = { 0 };
-      static unsigned long *u[ MAXBIT + 1 ];
-      static unsigned long mdeg[ MAXDIM + 1 ] = { // degree of
-         0,                                       // primitive polynomial
+      static const unsigned long mdeg[ MAXDIM + 1 ] = { // degree of
+         0,                                             // primitive polynomial
          1, 2, 3, 3, 4, 4
       };
-      static unsigned long p[ MAXDIM + 1 ] = {   // decimal encoded
-         0,                                      // interior bits
+      static const unsigned long p[ MAXDIM + 1 ] = {   // decimal encoded
+         0,                                            // interior bits
          0, 1, 1, 2, 1, 4
       };
-      static unsigned long v[ MAXDIM * MAXBIT + 1 ] = {
+      static const unsigned long v0[ 4 * MAXDIM + 1 ] = {   // initial direction numbers
           0,
           1,  1, 1,  1,  1,  1,
           3,  1, 3,  3,  1,  1,
@@ -920,15 +1663,19 @@ public:
          15, 11, 5, 15, 13,  9
       };
 
-      static double fac;
-      static int in = -1;
+      unsigned long* ix = _avoidance.ix;
+      unsigned long* v  = _avoidance.v;
+      unsigned long* u[ MAXBIT + 1 ];
+      double&        fac = _avoidance.fac;
+      int&           in = _avoidance.in;
       unsigned int j, k;
       unsigned long i, m, pp;
       
+      for ( j = 1, k = 0; j <= MAXBIT; j++, k += MAXDIM ) u[ j ] = &v[ k ];
       if ( in == -1 ) {
          in = 0;
          fac = 1. / ( 1L << MAXBIT );
-         for ( j = 1, k = 0; j <= MAXBIT; j++, k += MAXDIM ) u[ j ] = &v[ k ];
+         for ( k = 0; k <= MAXDIM * MAXBIT; k++ ) v[ k ] = k <= 4 * MAXDIM ? v0[ k ] : 0;
          for ( k = 1; k <= MAXDIM; k++ ) {
             for ( j = 1; j <= mdeg[ k ]; j++ ) u[ j ][ k ] <<= ( MAXBIT - j );
             for ( j = mdeg[ k ] + 1; j <= MAXBIT; j++ ) {
@@ -955,16 +1702,394 @@ public:
                              
 private:
 
-   Generator<Typename> *_gen;
-   static const unsigned int N_BITS = CHAR_BIT * sizeof( Typename );   // number of bits (32 or 64)
+   typedef engine<Typename> _engine;
+   typename _engine::type _gen;
+   static const unsigned int N_BITS = CHAR_BIT * sizeof( typename _engine::result_type );   // number of bits (32 or 64)
+   
+   // state that some distributions carry from one call to the next, kept per object so that
+   // separate Random objects never share anything (e.g., one per thread)
+   
+   static const int          N_DIM   = 6;      // most dimensions for sample( x, ndim )
+   static const int          N_COINS = 1024;   // most trials for which binomial( n, 0.5 ) counts coins
+   static const unsigned int MAXBIT  = 30;     // for avoidance
+   static const unsigned int MAXDIM  = 6;
+   
+   uint64_t _coins;    // fair coins: a reservoir of random bits, served from the low end
+   int      _nCoins;   // fair coins: number of bits left in _coins
+   
+   normal_method_t _normal;   // normal: Ziggurat or polar
+   bool   _polar;             // normal: whether _p2 holds the second variate of a polar pair
+   double _p2, _q;
+   
+   struct ziggurat_normal_table {   // normal: 256 layers of equal area V under exp( -x^2 / 2 ), the base one including the tail beyond R
+      double x[ 257 ];   // right edge of layer i is x[i], with x[0] = V / f(R) for the base, x[1] = R and x[256] = 0
+      double f[ 257 ];   // f[i] = exp( -x[i]^2 / 2 )
+      double r[ 256 ];   // r[i] = x[i+1] / x[i], the fraction of layer i that lies wholly under the curve
+      ziggurat_normal_table( void ) {
+      
+         const double R = 3.6541528853610088, V = 0.00492867323399;
+         x[0] = V / exp( -0.5 * R * R );
+         x[1] = R;
+         for ( int i = 1; i < 255; i++ ) x[i + 1] = sqrt( -2. * log( V / x[i] + exp( -0.5 * x[i] * x[i] ) ) );
+         x[256] = 0.;
+         for ( int i = 0; i <= 256; i++ ) f[i] = exp( -0.5 * x[i] * x[i] );
+         for ( int i = 0; i < 256; i++ ) r[i] = x[i + 1] / x[i];
+      }
+   } _zn;
+   
+   exponential_method_t _exponential;   // exponential: inversion or Ziggurat
+   
+   struct ziggurat_exponential_table {   // exponential: 256 layers of equal area V under exp( -x ), the base one including the tail beyond R
+      double x[ 257 ];   // right edge of layer i is x[i], with x[0] = V / f(R) for the base, x[1] = R and x[256] = 0
+      double f[ 257 ];   // f[i] = exp( -x[i] )
+      double r[ 256 ];   // r[i] = x[i+1] / x[i]
+      ziggurat_exponential_table( void ) {
+      
+         const double R = 7.69711747013104972, V = 0.0039496598225815571993;
+         x[0] = V / exp( -R );
+         x[1] = R;
+         for ( int i = 1; i < 255; i++ ) x[i + 1] = -log( V / x[i] + exp( -x[i] ) );
+         x[256] = 0.;
+         for ( int i = 0; i <= 256; i++ ) f[i] = exp( -x[i] );
+         for ( int i = 0; i < 256; i++ ) r[i] = x[i + 1] / x[i];
+      }
+   } _ze;
+   
+   struct empirical_state {   // empirical
+      empirical_table t;
+      bool            init;
+      empirical_state( void ) : init( false ) {}
+   } _empirical;
+   
+   struct empiricalDiscrete_state {   // empiricalDiscrete
+      std::vector< int > k;
+      alias_table        t;
+      bool               init;
+      empiricalDiscrete_state( void ) : init( false ) {}
+   } _empiricalDiscrete;
+   
+   struct sample_state {   // sample with or without replacement
+      std::vector< double > v;
+      bool init;
+      int  n, index;
+      sample_state( void ) : init( false ), n( 0 ), index( 0 ) {}
+   } _sample;
+   
+   struct sampleND_state {   // sample of multi-dimensional data
+      std::vector< double > v[ N_DIM ];
+      bool init;
+      int  n;
+      sampleND_state( void ) : init( false ), n( 0 ) {}
+   } _sampleND;
+   
+   struct stochastic_state {   // stochasticInterpolation
+      std::vector< point2d > data;
+      point2d min, max;
+      int     m;
+      double  lower, upper;
+      bool    init;
+      stochastic_state( void ) : m( 0 ), lower( 0. ), upper( 0. ), init( false ) {}
+   } _stochastic;
+   
+   struct avoidance_state {   // avoidance
+      unsigned long ix[ MAXDIM + 1 ];
+      unsigned long v[ MAXDIM * MAXBIT + 1 ];
+      double fac;
+      int    in;
+      avoidance_state( void ) : fac( 0. ), in( -1 ) { for ( unsigned int i = 0; i <= MAXDIM; i++ ) ix[ i ] = 0; }
+   } _avoidance;
+   
+   // uniforms in double arithmetic throughout: one 32-bit number for a 32-bit generator, and 53 bits (or 52 for the
+   // open interval, which keeps log( _uo() ) finite) from one 64-bit number for a 64-bit generator
+   
+   double _u( void ) {   // in [0,1)
+   
+      if ( N_BITS == 32 ) return double( _engine::rng32( _gen ) ) * double( TWO32_INV );
+      else                return to53_01( _engine::rng64( _gen ) );
+   }
+   
+   double _uo( void ) {   // in (0,1)
+   
+      if ( N_BITS == 32 ) return ( double( _engine::rng32( _gen ) ) + 0.5 ) * double( TWO32_INV );
+      else                return to52_open01( _engine::rng64( _gen ) );
+   }
+   
+   // uniforms in the precision of Real for the continuous distributions: 24 bits from one 32-bit number for float
+   // (23 for the open interval, where adding 1/2 is still exact), and _u() and _uo() otherwise, so that the double
+   // results are the same as without Real
+   
+   Real _ur( void ) {   // in [0,1)
+   
+      if ( sizeof( Real ) == sizeof( float ) ) return to24_01( _engine::rng32( _gen ) );
+      else                                     return _u();
+   }
    
-   long double _u( void ) {
+   Real _uro( void ) {   // in (0,1)
    
-      if ( N_BITS == 32 ) return _gen->rng32_01();
-      else                return _gen->rng64_01();
+      if ( sizeof( Real ) == sizeof( float ) ) return ( float( _engine::rng32( _gen ) >> 9 ) + 0.5f ) * TWO23_INV;
+      else                                     return _uo();
    }
    
-   static double _parabola( double x, double xMin, double xMax ) { // parabola
+   bool _coin( void ) {   // a fair coin, one bit from the reservoir, which refills with a 64-bit number
+   
+      if ( _nCoins == 0 ) {
+         _coins  = _engine::rng64( _gen );
+         _nCoins = 64;
+      }
+      bool c = _coins & 1;
+      _coins >>= 1;
+      _nCoins--;
+      return c;
+   }
+   
+   int _countCoins( int n ) {   // number of heads in n fair coins, a popcount per 64-bit number
+   
+      int k = 0;
+      for ( ; n >= 64; n -= 64 ) k += popcount64( _engine::rng64( _gen ) );
+      if ( n > _nCoins ) {   // the rest of the reservoir, then a fresh one
+         k += popcount64( _coins );
+         n -= _nCoins;
+         _coins  = _engine::rng64( _gen );
+         _nCoins = 64;
+      }
+      if ( n > 0 ) {
+         k += popcount64( _coins & ( ( uint64_t( 1 ) << n ) - 1 ) );
+         _coins >>= n;
+         _nCoins -= n;
+      }
+      return k;
+   }
+   
+   uint32_t _bounded( uint32_t range ) {   // unbiased integer in [0,range) as Generator::bounded32 makes it, 0 standing for 2^32
+   
+      if ( range == 0 ) return _engine::rng32( _gen );
+      uint64_t m = uint64_t( _engine::rng32( _gen ) ) * range;
+      if ( uint32_t( m ) < range ) {
+         uint32_t t = -range % range;
+         while ( uint32_t( m ) < t ) m = uint64_t( _engine::rng32( _gen ) ) * range;
+      }
+      return uint32_t( m >> 32 );
+   }
+   
+   // the batch versions of the distributions work through their arrays a block at a time, small enough that a block of
+   // uniforms from the generator's bulk fill is still in L1 cache when the transform loop, free of calls and branches
+   // where the distribution allows so that it vectorizes, turns it into variates
+   
+   static const size_t BLOCK = 512;
+   
+   void _uniforms( double x[], size_t n ) {   // fills x with n uniforms in [0,1), as _u() makes them
+   
+      if ( N_BITS == 32 ) _engine::fill32_01( _gen, x, n );
+      else                _engine::fill64_01( _gen, x, n );
+   }
+   
+   void _uniformsOpen( double x[], size_t n ) {   // fills x with n uniforms in (0,1), as _uo() makes them
+   
+      if ( N_BITS == 32 ) {
+         uint32_t b[ BLOCK ];
+         for ( size_t i = 0; i < n; i += BLOCK ) {
+            size_t m = std::min( BLOCK, n - i );
+            _engine::fill32( _gen, b, m );
+            for ( size_t j = 0; j < m; j++ ) x[ i + j ] = ( double( b[ j ] ) + 0.5 ) * double( TWO32_INV );
+         }
+      }
+      else _engine::get( _gen ).fill52_open01( x, n );
+   }
+   
+   void _uniforms( float x[], size_t n ) {   // fills x with n uniforms in [0,1), as _ur() makes them for float
+   
+      _engine::get( _gen ).fill24_01( x, n );
+   }
+   
+   void _uniformsOpen( float x[], size_t n ) {   // fills x with n uniforms in (0,1), as _uro() makes them for float
+   
+      uint32_t b[ BLOCK ];
+      for ( size_t i = 0; i < n; i += BLOCK ) {
+         size_t m = std::min( BLOCK, n - i );
+         _engine::fill32( _gen, b, m );
+         for ( size_t j = 0; j < m; j++ ) x[ i + j ] = ( float( b[ j ] >> 9 ) + 0.5f ) * TWO23_INV;
+      }
+   }
+   
+   void _uniforms( long double x[], size_t n ) {   // fills x with n uniforms in [0,1), as _ur() makes them for long double
+   
+      double u[ BLOCK ];
+      for ( size_t i = 0; i < n; i += BLOCK ) {
+         size_t m = std::min( BLOCK, n - i );
+         _uniforms( u, m );
+         for ( size_t j = 0; j < m; j++ ) x[ i + j ] = u[ j ];
+      }
+   }
+   
+   void _uniformsOpen( long double x[], size_t n ) {   // fills x with n uniforms in (0,1), as _uro() makes them for long double
+   
+      double u[ BLOCK ];
+      for ( size_t i = 0; i < n; i += BLOCK ) {
+         size_t m = std::min( BLOCK, n - i );
+         _uniformsOpen( u, m );
+         for ( size_t j = 0; j < m; j++ ) x[ i + j ] = u[ j ];
+      }
+   }
+   
+   template <class R>   // double, or the Real of the continuous distributions
+   void _exps( R x[], size_t n ) {   // fills x with n standard exponentials, as _exp() makes them
+   
+      if ( _exponential == ZIGGURAT_EXPONENTIAL ) {
+         for ( size_t i = 0; i < n; i++ ) x[ i ] = _zigguratExponential();
+         return;
+      }
+      _uniformsOpen( x, n );
+      for ( size_t i = 0; i < n; i++ ) x[ i ] = -vmath::log( x[ i ] );
+   }
+   
+   // standard normal by the Ziggurat method of Marsaglia and Tsang: one 64-bit number supplies the layer (low 8 bits)
+   // and a signed 53-bit uniform (high bits), and about 99% of the time the result is just the uniform times the layer
+   // width; the rest come from the wedges under the curve or from the tail
+   // Ref: Marsaglia, G. and W. W. Tsang, "The Ziggurat Method for Generating Random Variables,"
+   //      Journal of Statistical Software, Vol. 5, Issue 8, 2000.
+   double _zigguratNormal( void ) {
+   
+      for (;;) {
+      
+         uint64_t b = _engine::rng64( _gen );
+         unsigned int i = b & 0xff;
+         double u = double( int64_t( b ) >> 11 ) * ( 2. * TWO53_INV );   // in [-1,1), so the sign costs no branch
+         double x = u * _zn.x[i];
+         
+         if ( fabs( u ) < _zn.r[i] ) return x;   // inside the rectangle under the curve
+         
+         if ( i == 0 ) {   // base layer, outside the rectangle: sample the tail beyond R
+         
+            const double R = _zn.x[1];
+            double xt, yt;
+            do {
+               xt = -log( 1. - _u() ) / R;
+               yt = -log( 1. - _u() );
+            } while ( yt + yt < xt * xt );
+            return u < 0. ? -( R + xt ) : R + xt;
+         }
+         
+         if ( _zn.f[i] + _u() * ( _zn.f[i + 1] - _zn.f[i] ) < exp( -0.5 * x * x ) ) return x;   // in the wedge
+      }
+   }
+   
+   // standard exponential by the Ziggurat method of Marsaglia and Tsang, laid out as _zigguratNormal;
+   // the tail beyond R is R plus another exponential, since the distribution is memoryless
+   double _zigguratExponential( void ) {
+   
+      double t = 0.;
+      for (;;) {
+      
+         uint64_t b = _engine::rng64( _gen );
+         unsigned int i = b & 0xff;
+         double u = double( b >> 11 ) * TWO53_INV;
+         double x = u * _ze.x[i];
+         
+         if ( u < _ze.r[i] ) return t + x;   // inside the rectangle under the curve
+         
+         if ( i == 0 ) t += _ze.x[1];        // base layer, outside the rectangle: start again beyond R
+         else if ( _ze.f[i] + _u() * ( _ze.f[i + 1] - _ze.f[i] ) < exp( -x ) ) return t + x;   // in the wedge
+      }
+   }
+   
+   double _exp( void ) {   // standard exponential, the -log(u) of the distributions that build on it
+   
+      if ( _exponential == ZIGGURAT_EXPONENTIAL ) return _zigguratExponential();
+      return -log( _uo() );
+   }
+   
+   // binomial by transformed rejection with squeeze, in expected constant time
+   // Ref: Hormann, W., "The Generation of Binomial Random Variates,"
+   //      Journal of Statistical Computation and Simulation, Vol. 46, pp. 101-110, 1993.
+   int _btrs( const binomial_param& g ) {
+   
+      while ( true ) {
+         double u  = _u() - 0.5;
+         double v  = _u();
+         double us = 0.5 - fabs( u );
+         double k  = floor( ( 2. * g.a / us + g.b ) * u + g.c );
+         if ( k < 0. || k > g.n ) continue;
+         if ( us >= 0.07 && v <= g.vr ) return int( k );
+         v = log( v * g.alpha / ( g.a / ( us * us ) + g.b ) );
+         if ( v <= g.h - lgamma( k + 1. ) - lgamma( g.n - k + 1. ) + ( k - g.m ) * g.lpq ) return int( k );
+      }
+   }
+   
+   int _binomialInversion( const binomial_param& g ) {   // binomial by sequential search up the pmf, for small means
+   
+      while ( true ) {
+         double u = _u();
+         double r = g.r0;   // P(k)
+         for ( int k = 0; k <= g.n; k++ ) {
+            if ( u < r ) return k;
+            u -= r;
+            r *= g.s * double( g.n - k ) / double( k + 1 );
+         }
+      }   // start again in the rare case that rounding leaves u above the total
+   }
+   
+   // Poisson by transformed rejection with squeeze, in expected constant time
+   // Ref: Hormann, W., "The Transformed Rejection Method for Generating Poisson Random Variables,"
+   //      Insurance: Mathematics and Economics, Vol. 12, pp. 39-45, 1993.
+   int _ptrs( const poisson_param& g ) {
+   
+      while ( true ) {
+         double u  = _u() - 0.5;
+         double v  = _u();
+         double us = 0.5 - fabs( u );
+         double k  = floor( ( 2. * g.a / us + g.b ) * u + g.mu + 0.43 );
+         if ( us >= 0.07 && v <= g.vr ) return int( k );
+         if ( k < 0. || ( us < 0.013 && v > us ) ) continue;
+         if ( log( v ) + g.lalpha - log( g.a / ( us * us ) + g.b ) <= -g.mu + k * g.lmu - lgamma( k + 1. ) ) return int( k );
+      }
+   }
+   
+   int _poissonInversion( const poisson_param& g ) {   // Poisson by sequential search up the pmf, for small means
+   
+      while ( true ) {
+         double u = _u();
+         double r = g.p0;   // P(k)
+         for ( int k = 0; r > 0.; k++ ) {
+            if ( u < r ) return k;
+            u -= r;
+            r *= g.mu / double( k + 1 );
+         }
+      }   // start again in the rare case that rounding leaves u above the total
+   }
+   
+   // hypergeometric by the ratio of uniforms with the hat of Stadlober, in expected constant time
+   // Ref: Stadlober, E., "The Ratio of Uniforms Approach for Generating Discrete Random Variates,"
+   //      Journal of Computational and Applied Mathematics, Vol. 31, pp. 181-189, 1990.
+   int _hrua( const hypergeometric_param& g ) {
+   
+      while ( true ) {
+         double u = 1. - _u();   // in (0,1]
+         double v = _u();
+         double x = g.a + g.h * ( v - 0.5 ) / u;
+         if ( x < 0. || x >= g.b ) continue;
+         double k = floor( x );
+         double t = g.g - ( g.logFactorial( k ) + g.logFactorial( g.ks - k ) + g.logFactorial( g.ns - k ) + g.logFactorial( g.N - g.ks - g.ns + k ) );
+         if ( u * ( 4. - u ) - 3. <= t ) return int( k );   // squeeze acceptance
+         if ( u * ( u - t ) >= 1. ) continue;              // squeeze rejection
+         if ( 2. * log( u ) <= t ) return int( k );
+      }
+   }
+   
+   int _hypergeometricInversion( const hypergeometric_param& g ) {   // hypergeometric by sequential search, for small means
+   
+      const int M = g.N - g.ks - g.ns;   // N - K' - n' >= 0
+      while ( true ) {
+         double u = _u();
+         double r = g.p0;   // P(k)
+         for ( int k = 0; k <= std::min( g.ns, g.ks ); k++ ) {
+            if ( u < r ) return k;
+            u -= r;
+            r *= double( g.ks - k ) * double( g.ns - k ) / ( double( k + 1 ) * double( M + k + 1 ) );
+         }
+      }   // start again in the rare case that rounding leaves u above the total
+   }
+   
+   static Real _parabola( Real x, Real xMin, Real xMax ) { // parabola
 
       if ( x < xMin || x > xMax ) return 0.0;
    
@@ -975,6 +2100,8 @@ private:
       return yMax * ( 1. - ( x - a ) * ( x - a ) / ( b * b ) );
    }
 }; // Random class
+
+template <class Typename, class Real> const size_t Random<Typename, Real>::BLOCK;
 } // rnd namespace
 
 #endif // RANDOM_H
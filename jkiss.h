@@ -37,6 +37,20 @@ namespace JKISS {
    static const uint64_t MWC_PERIOD   = 0x7ffd14247fffffffull;   // 9222549758923505663ull;
    static const uint32_t N_SEEDS      = 4;                       // requires four 32-bit words
 
+   static const unsigned int N_POWERS = 128;   // MATRIX^(2^k) for k < N_POWERS covers all of jump_cycle
+
+   inline const Bitpowers<uint32_t>& jump_powers( void ) {   // powers of MATRIX, built on first use (thread-safe)
+   
+      static const Bitpowers<uint32_t> P( MATRIX, N_POWERS );
+      return P;
+   }
+
+   inline const Bitpowers<uint32_t>& jump_powers_inv( void ) {   // powers of MATRIX_INV, built on first use (thread-safe)
+   
+      static const Bitpowers<uint32_t> P( MATRIX_INV, N_POWERS );
+      return P;
+   }
+
 class jkiss : public Generator<uint32_t> {
 
 public:
@@ -87,9 +101,7 @@ public:
    
 #endif // UINT64_C
 
-      Bitmatrix<uint32_t> A, B( MATRIX );
-      A = B^n;
-      _s2 = A * _s2;
+      _s2 = jump_powers().jump( n, _s2 );
       
       uint64_t a = _s3 + ( (uint64_t)_s4 << 32u );
       a = mul_mod64( pow_mod64( MWC_MULT, n, MWC_MOD ), a, MWC_MOD );
@@ -113,16 +125,7 @@ public:
    
 #endif // UINT64_C
 
-      Bitmatrix<uint32_t> A, B;
-   
-      if ( e ) {
-         B = MATRIX;
-         for ( size_t i = 0; i < e; i++ ) B *= B;
-      }
-      A = MATRIX;
-      A = A^c;
-      if ( e ) A *= B;
-      _s2 = A * _s2;
+      _s2 = jump_powers().jump( e, c, _s2 );
       
       uint64_t a = _s3 + ( (uint64_t)_s4 << 32u );
       a = mul_mod64( pow_mod64( MWC_MULT, e, c, MWC_MOD ), a, MWC_MOD );
@@ -148,9 +151,7 @@ public:
    
 #endif // UINT64_C
 
-      Bitmatrix<uint32_t> A( MATRIX_INV );
-      A = A^n;
-      _s2 = A * _s2;
+      _s2 = jump_powers_inv().jump( n, _s2 );
 
       uint64_t a = _s3 + ( (uint64_t)_s4 << 32u );
       a = mul_mod64( pow_mod64( MWC_MULT_INV, n, MWC_MOD ), a, MWC_MOD );
@@ -176,16 +177,7 @@ public:
    
 #endif // UINT64_C
 
-      Bitmatrix<uint32_t> A, B;
-   
-      if ( e ) {
-         B = MATRIX_INV;
-         for ( size_t i = 0; i < e; i++ ) B *= B;
-      }
-      A = MATRIX_INV;
-      A = A^c;
-      if ( e ) A *= B;
-      _s2 = A * _s2;
+      _s2 = jump_powers_inv().jump( e, c, _s2 );
       
       uint64_t a = _s3 + ( (uint64_t)_s4 << 32u );
       a = mul_mod64( pow_mod64( MWC_MULT_INV, e, c, MWC_MOD ), a, MWC_MOD );
@@ -241,7 +233,7 @@ public:
    
    virtual double rng32_01( void ) { // returns a double in the half-open interval [0,1)
    
-      return double( rng32() ) * TWO32_INV;
+      return double( rng32() ) * double( TWO32_INV );
    }
    
    virtual long double rng64_01( void ) {   // returns a long double in [0,1)
@@ -249,6 +241,26 @@ public:
       return double( rng64() ) * TWO64_INV;
    }
    
+   virtual void fill32( uint32_t x[], size_t n ) {   // fills x with n 32-bit integers
+   
+      for ( size_t i = 0; i < n; i++ ) x[i] = jkiss::rng32();
+   }
+   
+   virtual void fill64( uint64_t x[], size_t n ) {   // fills x with n 64-bit integers
+   
+      for ( size_t i = 0; i < n; i++ ) x[i] = jkiss::rng64();
+   }
+   
+   virtual void fill32_01( double x[], size_t n ) {   // fills x with n doubles in [0,1)
+   
+      for ( size_t i = 0; i < n; i++ ) x[i] = double( jkiss::rng32() ) * double( TWO32_INV );
+   }
+   
+   virtual void fill64_01( double x[], size_t n ) {   // fills x with n doubles in [0,1), 53 bits of resolution
+   
+      for ( size_t i = 0; i < n; i++ ) x[i] = double( jkiss::rng64() >> 11 ) * TWO53_INV;
+   }
+   
 private:
 
    uint32_t _s1, _s2, _s3, _s4;
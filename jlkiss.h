@@ -45,6 +45,20 @@ namespace JLKISS {
    static const uint64_t MWC_PERIOD   = 0x7ffd14247fffffffull;   // 9222549758923505663ull;
    static const uint32_t N_SEEDS      = 3;                       // requires three 64-bit words
 
+   static const unsigned int N_POWERS = 192;   // MATRIX^(2^k) for k < N_POWERS covers all of jump_cycle
+
+   inline const Bitpowers<uint64_t>& jump_powers( void ) {   // powers of MATRIX, built on first use (thread-safe)
+   
+      static const Bitpowers<uint64_t> P( MATRIX, N_POWERS );
+      return P;
+   }
+
+   inline const Bitpowers<uint64_t>& jump_powers_inv( void ) {   // powers of MATRIX_INV, built on first use (thread-safe)
+   
+      static const Bitpowers<uint64_t> P( MATRIX_INV, N_POWERS );
+      return P;
+   }
+
 class jlkiss : public Generator<uint64_t> {
 
 public:
@@ -82,9 +96,7 @@ public:
       
       _s1 = mul64( pow64( LC_MULT, n ), _s1 ) + mul64( LC_CONST, gs64( LC_MULT, n ) );
       
-      Bitmatrix<uint64_t> A, B( MATRIX );
-      A = B^n;
-      _s2 = A * _s2;
+      _s2 = jump_powers().jump( n, _s2 );
       
       uint64_t a = _s3 + ( (uint64_t)_s4 << 32u );
       a = mul_mod64( pow_mod64( MWC_MULT, n, MWC_MOD ), a, MWC_MOD );
@@ -96,16 +108,7 @@ public:
       
       _s1 = mul64( pow64( LC_MULT, e, c ), _s1 ) + mul64( LC_CONST, gs64( LC_MULT, e, c ) );
       
-      Bitmatrix<uint64_t> A, B;
-   
-      if ( e ) {
-         B = MATRIX;
-         for ( uint64_t i = 0; i < e; i++ ) B *= B;
-      }
-      A = MATRIX;
-      A = A^c;
-      if ( e ) A *= B;
-      _s2 = A * _s2;
+      _s2 = jump_powers().jump( e, c, _s2 );
       
       uint64_t a = _s3 + ( (uint64_t)_s4 << 32u );
       a = mul_mod64( pow_mod64( MWC_MULT, e, c, MWC_MOD ), a, MWC_MOD );
@@ -117,9 +120,7 @@ public:
    
       _s1 = mul64( pow64( LC_MULT_INV, n ), _s1 - LC_CONST ) + LC_CONST - mul64( LC_CONST, gs64( LC_MULT_INV, n ) );
       
-      Bitmatrix<uint64_t> A, B( MATRIX_INV );
-      A = B^n;
-      _s2 = A * _s2;
+      _s2 = jump_powers_inv().jump( n, _s2 );
       
       uint64_t a = _s3 + ( (uint64_t)_s4 << 32u );
       a = mul_mod64( pow_mod64( MWC_MULT_INV, n, MWC_MOD ), a, MWC_MOD );
@@ -131,16 +132,7 @@ public:
    
       _s1 = mul64( pow64( LC_MULT_INV, e, c ), _s1 - LC_CONST ) + LC_CONST - mul64( LC_CONST, gs64( LC_MULT_INV, e, c ) );
       
-      Bitmatrix<uint64_t> A, B;
-   
-      if ( e ) {
-         B = MATRIX_INV;
-         for ( uint64_t i = 0; i < e; i++ ) B *= B;
-      }
-      A = MATRIX_INV;
-      A = A^c;
-      if ( e ) A *= B;
-      _s2 = A * _s2;
+      _s2 = jump_powers_inv().jump( e, c, _s2 );
       
       uint64_t a = _s3 + ( (uint64_t)_s4 << 32u );
       a = mul_mod64( pow_mod64( MWC_MULT_INV, e, c, MWC_MOD ), a, MWC_MOD );
@@ -198,13 +190,33 @@ public:
 
    double rng32_01( void ) { // returns a random number in the half-open interval [0,1)
    
-      return double( rng32() ) * TWO32_INV;
+      return double( rng32() ) * double( TWO32_INV );
    }
 
    long double rng64_01( void ) { // returns a random number in the half-open interval [0,1)
    
       return ( long double )( rng64() ) * TWO64_INV;
    }
+   
+   void fill32( uint32_t x[], size_t n ) {   // fills x with n 32-bit integers
+   
+      for ( size_t i = 0; i < n; i++ ) x[i] = jlkiss::rng32();
+   }
+   
+   void fill64( uint64_t x[], size_t n ) {   // fills x with n 64-bit integers
+   
+      for ( size_t i = 0; i < n; i++ ) x[i] = jlkiss::rng64();
+   }
+   
+   void fill32_01( double x[], size_t n ) {   // fills x with n doubles in [0,1)
+   
+      for ( size_t i = 0; i < n; i++ ) x[i] = double( jlkiss::rng32() ) * double( TWO32_INV );
+   }
+   
+   void fill64_01( double x[], size_t n ) {   // fills x with n doubles in [0,1), 53 bits of resolution
+   
+      for ( size_t i = 0; i < n; i++ ) x[i] = double( jlkiss::rng64() >> 11 ) * TWO53_INV;
+   }
 
 private:
    
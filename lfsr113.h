@@ -84,13 +84,39 @@ static const uint32_t C2 = 0xfffffff8ul;   // 4294967288ul
 static const uint32_t C3 = 0xfffffff0ul;   // 4294967280ul
 static const uint32_t C4 = 0xffffff80ul;   // 4294967168ul
 
+static const unsigned int N_POWERS = 114;   // MATRIX[i]^(2^k), or x^(2^k), for k < N_POWERS covers all of jump_cycle
+
+inline const Bitpowers<uint32_t>& jump_powers( size_t i ) {   // powers of MATRIX[i], built on first use (thread-safe)
+
+   static const std::vector< Bitpowers<uint32_t> > P = bitpowers<uint32_t>( MATRIX, N_SEEDS, N_POWERS );
+   return P[i];
+}
+
+inline const Bitpowers<uint32_t>& jump_powers_inv( size_t i ) {   // powers of MATRIX_INV[i], built on first use (thread-safe)
+
+   static const std::vector< Bitpowers<uint32_t> > P = bitpowers<uint32_t>( MATRIX_INV, N_SEEDS, N_POWERS );
+   return P[i];
+}
+
+inline const Bitpoly<uint32_t>& jump_polys( size_t i ) {   // minimal polynomial and powers of x for MATRIX[i], built on first use (thread-safe)
+
+   static const std::vector< Bitpoly<uint32_t> > P = bitpolys<uint32_t>( MATRIX, N_SEEDS, N_POWERS );
+   return P[i];
+}
+
+inline const Bitpoly<uint32_t>& jump_polys_inv( size_t i ) {   // minimal polynomial and powers of x for MATRIX_INV[i], built on first use (thread-safe)
+
+   static const std::vector< Bitpoly<uint32_t> > P = bitpolys<uint32_t>( MATRIX_INV, N_SEEDS, N_POWERS );
+   return P[i];
+}
+
 class lfsr113 : public Generator<uint32_t> {
 
 public:
-   lfsr113 ( void ) { // default constructor
+   lfsr113 ( void ) : _jump( MATRIX_JUMP ) { // default constructor
    }
 
-   lfsr113 ( std::vector<uint32_t> seed ) { // constructor from vector seed
+   lfsr113 ( std::vector<uint32_t> seed ) : _jump( MATRIX_JUMP ) { // constructor from vector seed
    
       setState( seed );
    }
@@ -117,56 +143,41 @@ public:
       for ( size_t i = 0; i < N_SEEDS; i++ ) seed[i] = _s[i];
    }
    
+   void jump_engine( jump_engine_t j ) {   // jump by cached matrix powers (the default) or by polynomials mod 2
+   
+      _jump = j;
+   }
+   
    virtual void jump_ahead( uintmax_t n ) { // jumps ahead the next n random numbers
-		
-		for ( size_t i = 0; i < N_SEEDS; i++ ) {
-      
-         Bitmatrix<uint32_t> A( MATRIX[i] );
-         _s[i] = ( A^n ) * _s[i];
-      }
+
+      if ( _jump == POLYNOMIAL_JUMP )
+         for ( size_t i = 0; i < N_SEEDS; i++ ) _s[i] = jump_polys( i ).jump( n, _s[i] );
+      else
+         for ( size_t i = 0; i < N_SEEDS; i++ ) _s[i] = jump_powers( i ).jump( n, _s[i] );
    }
    
    virtual void jump_ahead( uintmax_t e, uintmax_t c ) {   // jumps ahead the next n random numbers, where n = 2^e + c
-		
-		Bitmatrix<uint32_t> A, B;
-		
-		for ( size_t i = 0; i < N_SEEDS; i++ ) {
-      
-         if ( e ) {
-            B = MATRIX[i];
-            for ( uintmax_t j = 0; j < e; j++ ) B *= B;
-         }
-         A = MATRIX[i];
-         A = A^c;
-         if ( e ) A *= B;
-         _s[i] = A * _s[i];
-      }
+
+      if ( _jump == POLYNOMIAL_JUMP )
+         for ( size_t i = 0; i < N_SEEDS; i++ ) _s[i] = jump_polys( i ).jump( e, c, _s[i] );
+      else
+         for ( size_t i = 0; i < N_SEEDS; i++ ) _s[i] = jump_powers( i ).jump( e, c, _s[i] );
    }
    
    virtual void jump_back( uintmax_t n ) { // jumps ahead the next n random numbers
-		
-		for ( size_t i = 0; i < N_SEEDS; i++ ) {
-      
-         Bitmatrix<uint32_t> A( MATRIX_INV[i] );
-         _s[i] = ( A^n ) * _s[i];
-      }
+
+      if ( _jump == POLYNOMIAL_JUMP )
+         for ( size_t i = 0; i < N_SEEDS; i++ ) _s[i] = jump_polys_inv( i ).jump( n, _s[i] );
+      else
+         for ( size_t i = 0; i < N_SEEDS; i++ ) _s[i] = jump_powers_inv( i ).jump( n, _s[i] );
    }
    
    virtual void jump_back( uintmax_t e, uintmax_t c ) {   // jumps ahead the next n random numbers, where n = 2^e + c
-   
-      Bitmatrix<uint32_t> A, B;
-		
-		for ( size_t i = 0; i < N_SEEDS; i++ ) {
-      
-         if ( e ) {
-            B = MATRIX_INV[i];
-            for ( uintmax_t j = 0; j < e; j++ ) B *= B;
-         }
-         A = MATRIX_INV[i];
-         A = A^c;
-         if ( e ) A *= B;
-         _s[i] = A * _s[i];
-      }
+
+      if ( _jump == POLYNOMIAL_JUMP )
+         for ( size_t i = 0; i < N_SEEDS; i++ ) _s[i] = jump_polys_inv( i ).jump( e, c, _s[i] );
+      else
+         for ( size_t i = 0; i < N_SEEDS; i++ ) _s[i] = jump_powers_inv( i ).jump( e, c, _s[i] );
    }
    
    virtual void jump_cycle( void ) { // jump ahead an entire cycle of lfsr113
@@ -216,17 +227,38 @@ public:
    
    virtual double rng32_01( void ) {   // returns a double int the half-open interval [0,1)
    
-      return double( rng32() ) * TWO32_INV;
+      return double( rng32() ) * double( TWO32_INV );
    }
    
    virtual long double rng64_01( void ) {   // returns a long double in [0,1)
    
       return double( rng64() ) * TWO64_INV;
    }
+   
+   virtual void fill32( uint32_t x[], size_t n ) {   // fills x with n 32-bit integers
+   
+      for ( size_t i = 0; i < n; i++ ) x[i] = lfsr113::rng32();
+   }
+   
+   virtual void fill64( uint64_t x[], size_t n ) {   // fills x with n 64-bit integers
+   
+      for ( size_t i = 0; i < n; i++ ) x[i] = lfsr113::rng64();
+   }
+   
+   virtual void fill32_01( double x[], size_t n ) {   // fills x with n doubles in [0,1)
+   
+      for ( size_t i = 0; i < n; i++ ) x[i] = double( lfsr113::rng32() ) * double( TWO32_INV );
+   }
+   
+   virtual void fill64_01( double x[], size_t n ) {   // fills x with n doubles in [0,1), 53 bits of resolution
+   
+      for ( size_t i = 0; i < n; i++ ) x[i] = double( lfsr113::rng64() >> 11 ) * TWO53_INV;
+   }
 
 private:
 
    uint32_t _s[ N_SEEDS ];
+   jump_engine_t _jump;   // how jumps are done
 
 }; // end lfsr113 class
 } // end namespace LFSR113
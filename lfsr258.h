@@ -142,13 +142,39 @@ static const uint64_t C3 = 0xfffffffffffff000ull;   // 18446744073709547520ull
 static const uint64_t C4 = 0xfffffffffffe0000ull;   // 18446744073709420544ull
 static const uint64_t C5 = 0xffffffffff800000ull;   // 18446744073701163008ull
 
+static const unsigned int N_POWERS = 259;   // MATRIX[i]^(2^k), or x^(2^k), for k < N_POWERS covers all of jump_cycle
+
+inline const Bitpowers<uint64_t>& jump_powers( size_t i ) {   // powers of MATRIX[i], built on first use (thread-safe)
+
+   static const std::vector< Bitpowers<uint64_t> > P = bitpowers<uint64_t>( MATRIX, N_SEEDS, N_POWERS );
+   return P[i];
+}
+
+inline const Bitpowers<uint64_t>& jump_powers_inv( size_t i ) {   // powers of MATRIX_INV[i], built on first use (thread-safe)
+
+   static const std::vector< Bitpowers<uint64_t> > P = bitpowers<uint64_t>( MATRIX_INV, N_SEEDS, N_POWERS );
+   return P[i];
+}
+
+inline const Bitpoly<uint64_t>& jump_polys( size_t i ) {   // minimal polynomial and powers of x for MATRIX[i], built on first use (thread-safe)
+
+   static const std::vector< Bitpoly<uint64_t> > P = bitpolys<uint64_t>( MATRIX, N_SEEDS, N_POWERS );
+   return P[i];
+}
+
+inline const Bitpoly<uint64_t>& jump_polys_inv( size_t i ) {   // minimal polynomial and powers of x for MATRIX_INV[i], built on first use (thread-safe)
+
+   static const std::vector< Bitpoly<uint64_t> > P = bitpolys<uint64_t>( MATRIX_INV, N_SEEDS, N_POWERS );
+   return P[i];
+}
+
 class lfsr258 : public Generator<uint64_t> {
 
 public:
-   lfsr258( void ) { // default constructor
+   lfsr258( void ) : _jump( MATRIX_JUMP ), _half( false ) { // default constructor
    }
    
-   lfsr258( std::vector<uint64_t> seed ) { // constructor from vector seed
+   lfsr258( std::vector<uint64_t> seed ) : _jump( MATRIX_JUMP ), _half( false ) { // constructor from vector seed
    
       setState( seed );
    }
@@ -168,6 +194,7 @@ public:
       _s[2] = seed[2]; if ( _s[2] <    4096 ) _s[2] +=    4096;
       _s[3] = seed[3]; if ( _s[3] <  131072 ) _s[3] +=  131072;
       _s[4] = seed[4]; if ( _s[4] < 8388608 ) _s[4] += 8388608;
+      _half = false;
    }
    
    virtual void getState( std::vector<uint64_t>& seed ) { // get the seed vector
@@ -176,56 +203,45 @@ public:
       for ( size_t i = 0; i < N_SEEDS; i++ ) seed[i] = _s[i];
    }
    
+   void jump_engine( jump_engine_t j ) {   // jump by cached matrix powers (the default) or by polynomials mod 2
+   
+      _jump = j;
+   }
+   
    virtual void jump_ahead( uintmax_t n ) { // jump ahead the next n random numbers
-      
-      for ( size_t i = 0; i < N_SEEDS; i++ ) {
-      
-         Bitmatrix<uint64_t> A( MATRIX[i] );
-         _s[i] = ( A^n ) * _s[i];
-      }
+
+      if ( _jump == POLYNOMIAL_JUMP )
+         for ( size_t i = 0; i < N_SEEDS; i++ ) _s[i] = jump_polys( i ).jump( n, _s[i] );
+      else
+         for ( size_t i = 0; i < N_SEEDS; i++ ) _s[i] = jump_powers( i ).jump( n, _s[i] );
+      _half = false;   // the held high half predates the jump
    }
    
    virtual void jump_ahead( uintmax_t e, uintmax_t c ) {   // jump ahead the next n random numbers, where n = 2^e + c
 
-      Bitmatrix<uint64_t> A, B;
-      
-      for ( size_t i = 0; i < N_SEEDS; i++ ) {
-      
-         if ( e ) {
-            B = MATRIX[i];
-            for ( uintmax_t j = 0; j < e; j++ ) B *= B;
-         }
-         A = MATRIX[i];
-         A = A^c;
-         if ( e ) A *= B;
-         _s[i] = A * _s[i];
-      }
+      if ( _jump == POLYNOMIAL_JUMP )
+         for ( size_t i = 0; i < N_SEEDS; i++ ) _s[i] = jump_polys( i ).jump( e, c, _s[i] );
+      else
+         for ( size_t i = 0; i < N_SEEDS; i++ ) _s[i] = jump_powers( i ).jump( e, c, _s[i] );
+      _half = false;
    }
    
    virtual void jump_back( uintmax_t n ) { // jump ahead the next n random numbers
-      
-      for ( size_t i = 0; i < N_SEEDS; i++ ) {
-      
-         Bitmatrix<uint64_t> A( MATRIX_INV[i] );
-         _s[i] = ( A^n ) * _s[i];
-      }
+
+      if ( _jump == POLYNOMIAL_JUMP )
+         for ( size_t i = 0; i < N_SEEDS; i++ ) _s[i] = jump_polys_inv( i ).jump( n, _s[i] );
+      else
+         for ( size_t i = 0; i < N_SEEDS; i++ ) _s[i] = jump_powers_inv( i ).jump( n, _s[i] );
+      _half = false;
    }
    
    virtual void jump_back( uintmax_t e, uintmax_t c ) {   // jump ahead the next n random numbers, where n = 2^e + c
-   
-      Bitmatrix<uint64_t> A, B;
-      
-      for ( size_t i = 0; i < N_SEEDS; i++ ) {
-      
-         if ( e ) {
-            B = MATRIX_INV[i];
-            for ( uintmax_t j = 0; j < e; j++ ) B *= B;
-         }
-         A = MATRIX_INV[i];
-         A = A^c;
-         if ( e ) A *= B;
-         _s[i] = A * _s[i];
-      }
+
+      if ( _jump == POLYNOMIAL_JUMP )
+         for ( size_t i = 0; i < N_SEEDS; i++ ) _s[i] = jump_polys_inv( i ).jump( e, c, _s[i] );
+      else
+         for ( size_t i = 0; i < N_SEEDS; i++ ) _s[i] = jump_powers_inv( i ).jump( e, c, _s[i] );
+      _half = false;
    }
    
    virtual void jump_cycle( void ) { // jump ahead an entire cycle of lfsr258
@@ -272,24 +288,16 @@ public:
 	}
 */
    
-   uint32_t rng32( void ) { // returns the next random number as a 32-bit integer
+   uint32_t rng32( void ) { // returns the next random number as a 32-bit integer, the low half of a 64-bit number and then the high half
 
-      static uint32_t u, l;
-      static bool f = true;
-      uint32_t n;
-      uint64_t v;
-   
-      if ( f ) {
-   
-         v = rng64();
-         l = ( uint32_t )( v >> 32 );
-         u = ( uint32_t )( v );
-         n = u;
+      if ( _half ) {
+         _half = false;
+         return _high;
       }
-      else n = l;
-   
-      f = !f;
-      return n;
+      uint64_t v = rng64();
+      _high = ( uint32_t )( v >> 32 );
+      _half = true;
+      return ( uint32_t )( v );
    }
    
    uint64_t rng64( void ) { // returns the next random number as a 64-bit integer
@@ -305,7 +313,7 @@ public:
    
    double rng32_01( void ) { // returns a random number in the half-open interval [0,1)
    
-      return rng32() * TWO32_INV;
+      return double( rng32() ) * double( TWO32_INV );
    }
    
    long double rng64_01( void ) { // returns a random number in the half-open interval [0,1)
@@ -313,9 +321,32 @@ public:
       return rng64() * TWO64_INV;
    }
    
+   void fill32( uint32_t x[], size_t n ) {   // fills x with n 32-bit integers
+   
+      for ( size_t i = 0; i < n; i++ ) x[i] = lfsr258::rng32();
+   }
+   
+   void fill64( uint64_t x[], size_t n ) {   // fills x with n 64-bit integers
+   
+      for ( size_t i = 0; i < n; i++ ) x[i] = lfsr258::rng64();
+   }
+   
+   void fill32_01( double x[], size_t n ) {   // fills x with n doubles in [0,1)
+   
+      for ( size_t i = 0; i < n; i++ ) x[i] = double( lfsr258::rng32() ) * double( TWO32_INV );
+   }
+   
+   void fill64_01( double x[], size_t n ) {   // fills x with n doubles in [0,1), 53 bits of resolution
+   
+      for ( size_t i = 0; i < n; i++ ) x[i] = double( lfsr258::rng64() >> 11 ) * TWO53_INV;
+   }
+   
 private:
    
    uint64_t _s[ N_SEEDS ];
+   jump_engine_t _jump;   // how jumps are done
+   bool     _half;        // whether _high holds the second half of a 64-bit number for rng32
+   uint32_t _high;
 
 }; // end lfsr258 class
 } // end namespace LFSR258
@@ -0,0 +1,117 @@
+// lfsr258_simd.h: lfsr258 running LANES independent streams side by side
+// lfsr258x4 keeps the four streams in 4 x 64-bit AVX2 registers and lfsr258x8 in 8 x 64-bit AVX-512 registers;
+// without those instruction sets the same lanes are stepped by a plain loop that the compiler can vectorize.
+// Lane k is bit-for-bit the scalar lfsr258 jumped ahead k * 2^e numbers (e = 128 by default) with the MATRIX[] tables.
+
+#ifndef LFSR258_SIMD_H
+#define LFSR258_SIMD_H
+
+#if defined( __AVX2__ ) || defined( __AVX512F__ )
+#include <immintrin.h>
+#endif
+
+namespace LFSR258 {
+
+template <unsigned int LANES>
+class lfsr258_simd : public Multilane<lfsr258, N_SEEDS, LANES> {
+
+   typedef Multilane<lfsr258, N_SEEDS, LANES> Base;
+   using Base::_s;
+
+public:
+   lfsr258_simd( unsigned int e = 128 ) : Base( e ) { // default constructor, lanes spaced 2^e apart
+   }
+
+   lfsr258_simd( std::vector<uint64_t> seed, unsigned int e = 128 ) : Base( seed, e ) { // constructor from vector seed
+   }
+
+   virtual ~lfsr258_simd() { // default destructor
+   }
+
+protected:
+
+   virtual void _generate( uint64_t x[], size_t m ) {   // m steps of all the lanes, interleaved into x
+
+#if defined( __AVX512F__ )
+      if ( LANES == 8 ) {
+
+         __m512i s0 = _mm512_loadu_si512( _s[0] ), c1 = _mm512_set1_epi64( C1 );
+         __m512i s1 = _mm512_loadu_si512( _s[1] ), c2 = _mm512_set1_epi64( C2 );
+         __m512i s2 = _mm512_loadu_si512( _s[2] ), c3 = _mm512_set1_epi64( C3 );
+         __m512i s3 = _mm512_loadu_si512( _s[3] ), c4 = _mm512_set1_epi64( C4 );
+         __m512i s4 = _mm512_loadu_si512( _s[4] ), c5 = _mm512_set1_epi64( C5 );
+
+         for ( size_t i = 0; i < m; i++ ) {
+
+            s0 = _mm512_xor_si512( _mm512_slli_epi64( _mm512_and_si512( s0, c1 ), 10 ),
+                                   _mm512_srli_epi64( _mm512_xor_si512( _mm512_slli_epi64( s0,  1 ), s0 ), 53 ) );
+            s1 = _mm512_xor_si512( _mm512_slli_epi64( _mm512_and_si512( s1, c2 ),  5 ),
+                                   _mm512_srli_epi64( _mm512_xor_si512( _mm512_slli_epi64( s1, 24 ), s1 ), 50 ) );
+            s2 = _mm512_xor_si512( _mm512_slli_epi64( _mm512_and_si512( s2, c3 ), 29 ),
+                                   _mm512_srli_epi64( _mm512_xor_si512( _mm512_slli_epi64( s2,  3 ), s2 ), 23 ) );
+            s3 = _mm512_xor_si512( _mm512_slli_epi64( _mm512_and_si512( s3, c4 ), 23 ),
+                                   _mm512_srli_epi64( _mm512_xor_si512( _mm512_slli_epi64( s3,  5 ), s3 ), 24 ) );
+            s4 = _mm512_xor_si512( _mm512_slli_epi64( _mm512_and_si512( s4, c5 ),  8 ),
+                                   _mm512_srli_epi64( _mm512_xor_si512( _mm512_slli_epi64( s4,  3 ), s4 ), 33 ) );
+            _mm512_storeu_si512( x + i * LANES, _mm512_xor_si512( _mm512_xor_si512( _mm512_xor_si512( s0, s1 ), _mm512_xor_si512( s2, s3 ) ), s4 ) );
+         }
+         _mm512_storeu_si512( _s[0], s0 );
+         _mm512_storeu_si512( _s[1], s1 );
+         _mm512_storeu_si512( _s[2], s2 );
+         _mm512_storeu_si512( _s[3], s3 );
+         _mm512_storeu_si512( _s[4], s4 );
+         return;
+      }
+#endif // __AVX512F__
+
+#if defined( __AVX2__ )
+      if ( LANES == 4 ) {
+
+         __m256i s0 = _mm256_loadu_si256( ( const __m256i* )_s[0] ), c1 = _mm256_set1_epi64x( C1 );
+         __m256i s1 = _mm256_loadu_si256( ( const __m256i* )_s[1] ), c2 = _mm256_set1_epi64x( C2 );
+         __m256i s2 = _mm256_loadu_si256( ( const __m256i* )_s[2] ), c3 = _mm256_set1_epi64x( C3 );
+         __m256i s3 = _mm256_loadu_si256( ( const __m256i* )_s[3] ), c4 = _mm256_set1_epi64x( C4 );
+         __m256i s4 = _mm256_loadu_si256( ( const __m256i* )_s[4] ), c5 = _mm256_set1_epi64x( C5 );
+
+         for ( size_t i = 0; i < m; i++ ) {
+
+            s0 = _mm256_xor_si256( _mm256_slli_epi64( _mm256_and_si256( s0, c1 ), 10 ),
+                                   _mm256_srli_epi64( _mm256_xor_si256( _mm256_slli_epi64( s0,  1 ), s0 ), 53 ) );
+            s1 = _mm256_xor_si256( _mm256_slli_epi64( _mm256_and_si256( s1, c2 ),  5 ),
+                                   _mm256_srli_epi64( _mm256_xor_si256( _mm256_slli_epi64( s1, 24 ), s1 ), 50 ) );
+            s2 = _mm256_xor_si256( _mm256_slli_epi64( _mm256_and_si256( s2, c3 ), 29 ),
+                                   _mm256_srli_epi64( _mm256_xor_si256( _mm256_slli_epi64( s2,  3 ), s2 ), 23 ) );
+            s3 = _mm256_xor_si256( _mm256_slli_epi64( _mm256_and_si256( s3, c4 ), 23 ),
+                                   _mm256_srli_epi64( _mm256_xor_si256( _mm256_slli_epi64( s3,  5 ), s3 ), 24 ) );
+            s4 = _mm256_xor_si256( _mm256_slli_epi64( _mm256_and_si256( s4, c5 ),  8 ),
+                                   _mm256_srli_epi64( _mm256_xor_si256( _mm256_slli_epi64( s4,  3 ), s4 ), 33 ) );
+            _mm256_storeu_si256( ( __m256i* )( x + i * LANES ), _mm256_xor_si256( _mm256_xor_si256( _mm256_xor_si256( s0, s1 ), _mm256_xor_si256( s2, s3 ) ), s4 ) );
+         }
+         _mm256_storeu_si256( ( __m256i* )_s[0], s0 );
+         _mm256_storeu_si256( ( __m256i* )_s[1], s1 );
+         _mm256_storeu_si256( ( __m256i* )_s[2], s2 );
+         _mm256_storeu_si256( ( __m256i* )_s[3], s3 );
+         _mm256_storeu_si256( ( __m256i* )_s[4], s4 );
+         return;
+      }
+#endif // __AVX2__
+
+      for ( size_t i = 0; i < m; i++, x += LANES ) {   // portable version, the same recurrence lane by lane
+
+         for ( unsigned int k = 0; k < LANES; k++ ) _s[0][k] = ( ( _s[0][k] & C1 ) << 10 ) ^ ( ( ( _s[0][k] <<  1 ) ^ _s[0][k] ) >> 53 );
+         for ( unsigned int k = 0; k < LANES; k++ ) _s[1][k] = ( ( _s[1][k] & C2 ) <<  5 ) ^ ( ( ( _s[1][k] << 24 ) ^ _s[1][k] ) >> 50 );
+         for ( unsigned int k = 0; k < LANES; k++ ) _s[2][k] = ( ( _s[2][k] & C3 ) << 29 ) ^ ( ( ( _s[2][k] <<  3 ) ^ _s[2][k] ) >> 23 );
+         for ( unsigned int k = 0; k < LANES; k++ ) _s[3][k] = ( ( _s[3][k] & C4 ) << 23 ) ^ ( ( ( _s[3][k] <<  5 ) ^ _s[3][k] ) >> 24 );
+         for ( unsigned int k = 0; k < LANES; k++ ) _s[4][k] = ( ( _s[4][k] & C5 ) <<  8 ) ^ ( ( ( _s[4][k] <<  3 ) ^ _s[4][k] ) >> 33 );
+         for ( unsigned int k = 0; k < LANES; k++ ) x[k] = _s[0][k] ^ _s[1][k] ^ _s[2][k] ^ _s[3][k] ^ _s[4][k];
+      }
+   }
+
+}; // end lfsr258_simd class
+
+typedef lfsr258_simd<4> lfsr258x4;   // AVX2
+typedef lfsr258_simd<8> lfsr258x8;   // AVX-512
+
+} // end namespace LFSR258
+
+#endif // LFSR258_SIMD_H
@@ -0,0 +1,99 @@
+// lfsr88_simd.h: lfsr88 running LANES independent streams side by side
+// lfsr88x8 keeps the eight streams in 8 x 32-bit AVX2 registers and lfsr88x16 in 16 x 32-bit AVX-512 registers;
+// without those instruction sets the same lanes are stepped by a plain loop that the compiler can vectorize.
+// Lane k is bit-for-bit the scalar lfsr88 jumped ahead k * 2^e numbers (e = 64 by default).
+
+#ifndef LFSR88_SIMD_H
+#define LFSR88_SIMD_H
+
+#if defined( __AVX2__ ) || defined( __AVX512F__ )
+#include <immintrin.h>
+#endif
+
+namespace LFSR88 {
+
+template <unsigned int LANES>
+class lfsr88_simd : public Multilane<lfsr88, N_SEEDS, LANES> {
+
+   typedef Multilane<lfsr88, N_SEEDS, LANES> Base;
+   using Base::_s;
+
+public:
+   lfsr88_simd ( unsigned int e = 64 ) : Base( e ) { // default constructor, lanes spaced 2^e apart
+   }
+
+   lfsr88_simd ( std::vector<uint32_t> seed, unsigned int e = 64 ) : Base( seed, e ) { // constructor from vector seed
+   }
+
+   virtual ~lfsr88_simd() { // default destructor
+   }
+
+protected:
+
+   virtual void _generate( uint32_t x[], size_t m ) {   // m steps of all the lanes, interleaved into x
+
+#if defined( __AVX512F__ )
+      if ( LANES == 16 ) {
+
+         __m512i s0 = _mm512_loadu_si512( _s[0] ), c1 = _mm512_set1_epi32( C1 );
+         __m512i s1 = _mm512_loadu_si512( _s[1] ), c2 = _mm512_set1_epi32( C2 );
+         __m512i s2 = _mm512_loadu_si512( _s[2] ), c3 = _mm512_set1_epi32( C3 );
+
+         for ( size_t i = 0; i < m; i++ ) {
+
+            s0 = _mm512_xor_si512( _mm512_slli_epi32( _mm512_and_si512( s0, c1 ), 12 ),
+                                   _mm512_srli_epi32( _mm512_xor_si512( _mm512_slli_epi32( s0, 13 ), s0 ), 19 ) );
+            s1 = _mm512_xor_si512( _mm512_slli_epi32( _mm512_and_si512( s1, c2 ),  4 ),
+                                   _mm512_srli_epi32( _mm512_xor_si512( _mm512_slli_epi32( s1,  2 ), s1 ), 25 ) );
+            s2 = _mm512_xor_si512( _mm512_slli_epi32( _mm512_and_si512( s2, c3 ), 17 ),
+                                   _mm512_srli_epi32( _mm512_xor_si512( _mm512_slli_epi32( s2,  3 ), s2 ), 11 ) );
+            _mm512_storeu_si512( x + i * LANES, _mm512_xor_si512( _mm512_xor_si512( s0, s1 ), s2 ) );
+         }
+         _mm512_storeu_si512( _s[0], s0 );
+         _mm512_storeu_si512( _s[1], s1 );
+         _mm512_storeu_si512( _s[2], s2 );
+         return;
+      }
+#endif // __AVX512F__
+
+#if defined( __AVX2__ )
+      if ( LANES == 8 ) {
+
+         __m256i s0 = _mm256_loadu_si256( ( const __m256i* )_s[0] ), c1 = _mm256_set1_epi32( C1 );
+         __m256i s1 = _mm256_loadu_si256( ( const __m256i* )_s[1] ), c2 = _mm256_set1_epi32( C2 );
+         __m256i s2 = _mm256_loadu_si256( ( const __m256i* )_s[2] ), c3 = _mm256_set1_epi32( C3 );
+
+         for ( size_t i = 0; i < m; i++ ) {
+
+            s0 = _mm256_xor_si256( _mm256_slli_epi32( _mm256_and_si256( s0, c1 ), 12 ),
+                                   _mm256_srli_epi32( _mm256_xor_si256( _mm256_slli_epi32( s0, 13 ), s0 ), 19 ) );
+            s1 = _mm256_xor_si256( _mm256_slli_epi32( _mm256_and_si256( s1, c2 ),  4 ),
+                                   _mm256_srli_epi32( _mm256_xor_si256( _mm256_slli_epi32( s1,  2 ), s1 ), 25 ) );
+            s2 = _mm256_xor_si256( _mm256_slli_epi32( _mm256_and_si256( s2, c3 ), 17 ),
+                                   _mm256_srli_epi32( _mm256_xor_si256( _mm256_slli_epi32( s2,  3 ), s2 ), 11 ) );
+            _mm256_storeu_si256( ( __m256i* )( x + i * LANES ), _mm256_xor_si256( _mm256_xor_si256( s0, s1 ), s2 ) );
+         }
+         _mm256_storeu_si256( ( __m256i* )_s[0], s0 );
+         _mm256_storeu_si256( ( __m256i* )_s[1], s1 );
+         _mm256_storeu_si256( ( __m256i* )_s[2], s2 );
+         return;
+      }
+#endif // __AVX2__
+
+      for ( size_t i = 0; i < m; i++, x += LANES ) {   // portable version, the same recurrence lane by lane
+
+         for ( unsigned int k = 0; k < LANES; k++ ) _s[0][k] = ( ( _s[0][k] & C1 ) << 12 ) ^ ( ( ( _s[0][k] << 13 ) ^ _s[0][k] ) >> 19 );
+         for ( unsigned int k = 0; k < LANES; k++ ) _s[1][k] = ( ( _s[1][k] & C2 ) <<  4 ) ^ ( ( ( _s[1][k] <<  2 ) ^ _s[1][k] ) >> 25 );
+         for ( unsigned int k = 0; k < LANES; k++ ) _s[2][k] = ( ( _s[2][k] & C3 ) << 17 ) ^ ( ( ( _s[2][k] <<  3 ) ^ _s[2][k] ) >> 11 );
+         for ( unsigned int k = 0; k < LANES; k++ ) x[k] = _s[0][k] ^ _s[1][k] ^ _s[2][k];
+      }
+   }
+
+}; // end lfsr88_simd class
+
+typedef lfsr88_simd<8>  lfsr88x8;    // AVX2
+typedef lfsr88_simd<16> lfsr88x16;   // AVX-512
+
+} // end namespace LFSR88
+
+#endif // LFSR88_SIMD_H
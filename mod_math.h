@@ -4,6 +4,7 @@
 
 #include <cstdint>
 #include <cassert>
+#include <climits>   // for CHAR_BIT
 
 static const uint64_t    M         = 4294967296ULL;                     // 2^32
 static const uint64_t    TWO32     = 4294967296ULL;                     // 2^32
@@ -12,6 +13,9 @@ static const long double TWO35     = 34359738368.0L;                    // 2^35
 static const long double TWO53     = 9007199254740992.0L;               // 2^53
 static const long double TWO32_INV = 2.328306436538696289062500e-10L;   // 2^(-32)
 static const long double TWO64_INV = 5.421010862427522170037264e-20L;   // 2^(-64)
+static const double      TWO53_INV = 1.110223024625156540423632e-16;    // 2^(-53)
+static const float       TWO24_INV = 5.9604644775390625e-08f;           // 2^(-24)
+static const float       TWO23_INV = 1.1920928955078125e-07f;           // 2^(-23)
 
 // a + b mod m
 uint32_t add_mod32( uint32_t a, uint32_t b, uint32_t m ) {
@@ -312,6 +316,12 @@ uint64_t add64( uint64_t a, uint64_t b ) {
 // 64-bit computation of a * b mod m
 uint64_t mul_mod64( uint64_t a, uint64_t b, uint64_t m ) {
 
+#ifdef __SIZEOF_INT128__ // use the native 128-bit product
+
+   return uint64_t( ( unsigned __int128 )( a ) * b % m );
+
+#else // native 128-bit not available, so perform multiplication by shifting and adding
+
    uint64_t r = 0;
    uint64_t t;
 
@@ -335,23 +345,103 @@ uint64_t mul_mod64( uint64_t a, uint64_t b, uint64_t m ) {
       b += t;
    }
    return r;
+
+#endif // __SIZEOF_INT128__
 }
 
 // 64-bit computation of a * b mod 2^64
 uint64_t mul64( uint64_t a, uint64_t b ) {
 
-   uint64_t r = 0;
-   uint64_t t;
+   return a * b;   // unsigned arithmetic is already mod 2^64
+}
 
-   while ( a != 0 ) {
+// full 128-bit product a * b: returns the high 64 bits and puts the low 64 bits in lo
+uint64_t mul128( uint64_t a, uint64_t b, uint64_t& lo ) {
+
+#ifdef __SIZEOF_INT128__ // use the native 128-bit product
+
+   unsigned __int128 t = ( unsigned __int128 )( a ) * b;
+   lo = uint64_t( t );
+   return uint64_t( t >> 64 );
+
+#else // native 128-bit not available, so combine the four 32-bit partial products
+
+   uint64_t a0 = a & 0xffffffffu, a1 = a >> 32;
+   uint64_t b0 = b & 0xffffffffu, b1 = b >> 32;
+   uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+   uint64_t mid = ( p00 >> 32 ) + ( p01 & 0xffffffffu ) + ( p10 & 0xffffffffu );   // cannot overflow
+   lo = ( mid << 32 ) | ( p00 & 0xffffffffu );
+   return p11 + ( p01 >> 32 ) + ( p10 >> 32 ) + ( mid >> 32 );
+
+#endif // __SIZEOF_INT128__
+}
+
+// number of 1 bits in x
+int popcount64( uint64_t x ) {
+
+#ifdef __GNUC__ // one POPCNT instruction where the target has it
+
+   return __builtin_popcountll( x );
+
+#else // count in parallel within the word
+
+   x = x - ( ( x >> 1 ) & 0x5555555555555555ULL );
+   x = ( x & 0x3333333333333333ULL ) + ( ( x >> 2 ) & 0x3333333333333333ULL );
+   x = ( x + ( x >> 4 ) ) & 0x0f0f0f0f0f0f0f0fULL;
+   return int( ( x * 0x0101010101010101ULL ) >> 56 );
+
+#endif // __GNUC__
+}
+
+#ifdef __SIZEOF_INT128__
+
+// Montgomery arithmetic mod an odd m < 2^64, with R = 2^64: numbers are held as x R mod m,
+// so that a product needs three 64-bit multiplications and no division
+struct montgomery64 {
+
+   montgomery64( uint64_t m ) : _m( m ) {   // constructor from the (odd) modulus
    
-      if ( a & 1 ) r += b;
-      a >>= 1;
-      t = b;
-      b += t;
+      assert( m & 1 );
+      uint64_t inv = m;                                  // m^-1 mod 2^3, since m * m = 1 mod 8 for odd m
+      for ( int i = 0; i < 5; i++ ) inv *= 2 - m * inv;   // Newton's method doubles the correct bits each time
+      _minv = -inv;
    }
-   return r;
-}
+   
+   uint64_t to( uint64_t a ) const {   // a R mod m
+   
+      return uint64_t( ( ( unsigned __int128 )( a % _m ) << 64 ) % _m );
+   }
+   
+   uint64_t from( uint64_t x ) const {   // x R^-1 mod m
+   
+      return _redc( x );
+   }
+   
+   uint64_t mul( uint64_t x, uint64_t y ) const {   // x y R^-1 mod m
+   
+      return _redc( ( unsigned __int128 )( x ) * y );
+   }
+
+private:
+
+   uint64_t _m;      // modulus
+   uint64_t _minv;   // -m^-1 mod 2^64
+   
+   uint64_t _redc( unsigned __int128 t ) const {   // t R^-1 mod m, for t < m R
+   
+      uint64_t u = uint64_t( t ) * _minv;
+      unsigned __int128 v = ( unsigned __int128 )( u ) * _m;   // t + v = 0 mod R
+      uint64_t th = uint64_t( t >> 64 ), vh = uint64_t( v >> 64 );
+      uint64_t r = th + vh;
+      bool carry = r < th;
+      uint64_t s = r + ( uint64_t( t ) != 0 );   // carry out of the low halves, which sum to 0 or R
+      carry |= s < r;
+      if ( carry || s >= _m ) s -= _m;          // ( t + v ) / R < 2m, which may not fit in 64 bits when m > 2^63
+      return s;
+   }
+};
+
+#endif // __SIZEOF_INT128__
 
 // 64-bit computation of a^n mod m
 uint64_t pow_mod64( uint64_t a, uintmax_t n, uint64_t m ) {
@@ -359,6 +449,26 @@ uint64_t pow_mod64( uint64_t a, uintmax_t n, uint64_t m ) {
    if ( n == 0 ) return 1;
    if ( n == 1 ) return a %= m;
    
+#ifdef __SIZEOF_INT128__ // Montgomery form for an odd modulus, as with the MWC moduli
+   
+   if ( m & 1 ) {
+   
+      montgomery64 g( m );
+      uint64_t r = g.to( 1 );
+      uint64_t t = g.to( a );
+      
+      for (;;) {
+         
+         if ( n & 1 ) r = g.mul( r, t );
+         n >>= 1;
+         if ( n == 0 ) break;
+         t = g.mul( t, t );
+      }
+      return g.from( r );
+   }
+   
+#endif // __SIZEOF_INT128__
+   
    uint64_t r = 1;
    uint64_t t = a;
    
@@ -376,6 +486,19 @@ uint64_t pow_mod64( uint64_t a, uintmax_t n, uint64_t m ) {
 uint64_t pow_mod64( uint64_t a, uintmax_t e, uintmax_t c, uint64_t m ) {
    
    if ( e == 0 ) return pow_mod64( a, c + 1, m );
+   
+#ifdef __SIZEOF_INT128__ // Montgomery form for an odd modulus, as with the MWC moduli
+   
+   if ( m & 1 ) {
+   
+      montgomery64 g( m );
+      uint64_t t = g.to( a );
+      for ( uint64_t i = 0; i < e; ++i ) t = g.mul( t, t );
+      return mul_mod64( pow_mod64( a, c, m ), g.from( t ), m );
+   }
+   
+#endif // __SIZEOF_INT128__
+   
    uint64_t t = a;
    for ( uint64_t i = 0; i < e; ++i ) t = mul_mod64( t, t, m );
    return mul_mod64( pow_mod64( a, c, m ), t, m );
@@ -407,22 +530,27 @@ uint64_t pow64( uint64_t a, uint64_t e, uint64_t c ) {
 }
 
 // 64-bit sum first n terms of geometric series: 1 + a + ... + a^(n-1) mod m
+// by doubling, S(2k) = S(k) (1 + a^k) and S(2k+1) = S(2k) + a^(2k), over the bits of n from the top: O(log n)
 uint64_t gs_mod64( uint64_t a, uintmax_t n, uint64_t m ) {
 
    if ( n == 0 ) return 0;
 
    uint64_t t = a % m;
-   uint64_t p = 1;
-   uint64_t r = 0;
+   uint64_t p = t;       // a^k
+   uint64_t r = 1 % m;   // S(k), starting from k = 1
+   int b = CHAR_BIT * sizeof( uintmax_t ) - 1;
+   while ( !( ( n >> b ) & 1 ) ) b--;
 
-   while ( n > 1 ) {
+   while ( --b >= 0 ) {
    
-      if ( n & 1 ) r = add_mod64( r, mul_mod64( p, pow_mod64( t, n - 1, m ), m ), m );
-      p = mul_mod64( p, add_mod64( 1, t, m ), m );
-      t = mul_mod64( t, t, m );
-      n >>= 1;
+      r = mul_mod64( r, add_mod64( 1, p, m ), m );
+      p = mul_mod64( p, p, m );
+      if ( ( n >> b ) & 1 ) {
+      
+         r = add_mod64( r, p, m );
+         p = mul_mod64( p, t, m );
+      }
    }
-   r = add_mod64( r, p, m );
    return r;
 }
 
@@ -444,24 +572,26 @@ uint64_t gs_mod64( uint64_t a, uint32_t e, uint32_t c, uint64_t m ) {
    return add_mod64( r, mul_mod64( t, gs_mod64( a, c, m ), m ), m );
 }
 
-// 64-bit sum first n terms of geometric series: 1 + a + ... + a^(n-1) mod 2^64
+// 64-bit sum first n terms of geometric series: 1 + a + ... + a^(n-1) mod 2^64, by doubling as with gs_mod64
 uint64_t gs64( uint64_t a, uintmax_t n ) {
 
    if ( n == 0 ) return 0;
-   if ( n == 1 ) return 1;
 
-   uint64_t t = a;
-   uint64_t p = 1;
-   uint64_t r = 0;
+   uint64_t p = a;   // a^k
+   uint64_t r = 1;   // S(k), starting from k = 1
+   int b = CHAR_BIT * sizeof( uintmax_t ) - 1;
+   while ( !( ( n >> b ) & 1 ) ) b--;
 
-   while ( n > 1 ) {
+   while ( --b >= 0 ) {
    
-      if ( n & 1 ) r += mul64( p, pow64( t, n - 1 ) );
-      p = mul64( p, 1 + t );
-      t = mul64( t, t );
-      n >>= 1;
+      r *= 1 + p;
+      p *= p;
+      if ( ( n >> b ) & 1 ) {
+      
+         r += p;
+         p *= a;
+      }
    }
-   r += p;
    return r;
 }
 